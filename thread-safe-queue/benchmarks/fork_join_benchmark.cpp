@@ -0,0 +1,66 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "work_stealing_pool.hpp"
+
+using namespace std;
+
+const int serial_cutoff = 20;
+
+uint64_t fibonacci_serial(int n)
+{
+    return n < 2 ? n : fibonacci_serial(n - 1) + fibonacci_serial(n - 2);
+}
+
+// recursive fork-join: forks fib(n-1) as a subtask, computes fib(n-2) in place, then joins
+uint64_t fibonacci(WorkStealingPool& pool, int n)
+{
+    if (n < serial_cutoff)
+        return fibonacci_serial(n);
+
+    auto f1 = pool.submit(fibonacci, ref(pool), n - 1);
+    const uint64_t f2 = fibonacci(pool, n - 2);
+    pool.wait(f1);
+
+    return f1.get() + f2;
+}
+
+int main()
+{
+    const int n = 38;
+
+    const auto start = chrono::steady_clock::now();
+    const uint64_t expected = fibonacci_serial(n);
+    const chrono::duration<double> serial_time = chrono::steady_clock::now() - start;
+
+    cout << "fibonacci(" << n << ") = " << expected << ", serial: " << serial_time.count() << " s" << endl;
+    cout << setw(16) << "workers" << setw(16) << "time [s]" << setw(16) << "speedup" << endl;
+
+    const size_t max_workers = max(1u, thread::hardware_concurrency());
+
+    vector<size_t> worker_counts;
+    for (size_t workers = 1; workers < max_workers; workers *= 2)
+        worker_counts.push_back(workers);
+    worker_counts.push_back(max_workers);
+
+    for (auto workers : worker_counts)
+    {
+        WorkStealingPool pool{workers};
+
+        const auto start = chrono::steady_clock::now();
+        const uint64_t result = pool.submit(fibonacci, ref(pool), n).get();
+        const chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+
+        if (result != expected)
+            cerr << "result mismatch!" << endl;
+
+        cout << setw(16) << workers
+             << setw(16) << elapsed.count()
+             << setw(16) << serial_time.count() / elapsed.count() << endl;
+    }
+}
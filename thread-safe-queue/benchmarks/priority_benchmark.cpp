@@ -0,0 +1,130 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "priority_thread_safe_queue.hpp"
+#include "thread_safe_queue.hpp"
+
+using namespace std;
+
+// Low-priority producers saturate the queue while one producer sends a high-priority item every 100us.
+// Reports push-to-pop latency of the high-priority items for the FIFO ThreadSafeQueue and
+// for PriorityThreadSafeQueue.
+
+using Clock = chrono::steady_clock;
+
+const int no_of_low_producers = 3;
+const int no_of_consumers = 2;
+const auto run_time = 500ms;
+const auto high_interval = 100us;
+
+struct Item
+{
+    bool high = false;
+    bool stop = false;
+    Clock::time_point enqueued;
+};
+
+void push(ThreadSafeQueue<Item>& q, const Item& item)
+{
+    q.push(item);
+}
+
+void push(PriorityThreadSafeQueue<Item>& q, const Item& item)
+{
+    q.push(item, item.high ? 0 : 1);
+}
+
+uint64_t percentile(vector<uint64_t>& samples, double p)
+{
+    if (samples.empty())
+        return 0;
+
+    const auto nth = samples.begin() + static_cast<ptrdiff_t>(p * (samples.size() - 1));
+    nth_element(samples.begin(), nth, samples.end());
+    return *nth;
+}
+
+template <typename Queue>
+void run(const string& queue_name, Queue& q)
+{
+    atomic<bool> stop_producers{false};
+    vector<vector<uint64_t>> latencies(no_of_consumers);
+    vector<thread> producers;
+    vector<thread> consumers;
+
+    for (int c = 0; c < no_of_consumers; ++c)
+        consumers.emplace_back([&q, &samples = latencies[c]] {
+            Item item;
+            for (;;)
+            {
+                q.pop(item);
+                if (item.stop)
+                    return;
+                if (item.high)
+                    samples.push_back(chrono::duration_cast<chrono::nanoseconds>(Clock::now() - item.enqueued).count());
+            }
+        });
+
+    for (int p = 0; p < no_of_low_producers; ++p)
+        producers.emplace_back([&q, &stop_producers] {
+            while (!stop_producers)
+                push(q, Item{false, false, Clock::now()});
+        });
+
+    producers.emplace_back([&q, &stop_producers] {
+        auto next = Clock::now();
+        while (!stop_producers)
+        {
+            push(q, Item{true, false, Clock::now()});
+            next += high_interval;
+            while (Clock::now() < next)
+                this_thread::yield();
+        }
+    });
+
+    this_thread::sleep_for(run_time);
+    stop_producers = true;
+
+    for (auto& thd : producers)
+        thd.join();
+
+    // stop items are low priority, so consumers drain everything queued before them
+    for (int c = 0; c < no_of_consumers; ++c)
+        push(q, Item{false, true, Clock::now()});
+
+    for (auto& thd : consumers)
+        thd.join();
+
+    vector<uint64_t> samples;
+    for (const auto& s : latencies)
+        samples.insert(samples.end(), s.begin(), s.end());
+
+    cout << setw(24) << queue_name
+         << setw(12) << samples.size()
+         << setw(16) << percentile(samples, 0.5)
+         << setw(16) << percentile(samples, 0.99)
+         << setw(16) << percentile(samples, 0.999) << endl;
+}
+
+int main()
+{
+    cout << setw(24) << "queue" << setw(12) << "high items"
+         << setw(16) << "p50 [ns]" << setw(16) << "p99 [ns]" << setw(16) << "p999 [ns]" << endl;
+
+    {
+        ThreadSafeQueue<Item> q;
+        run("ThreadSafeQueue", q);
+    }
+
+    {
+        PriorityThreadSafeQueue<Item> q{2};
+        run("PriorityThreadSafeQueue", q);
+    }
+}
@@ -0,0 +1,202 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "bounded_thread_safe_queue.hpp"
+#include "mpmc_queue.hpp"
+#include "sharded_thread_safe_queue.hpp"
+#include "spsc_queue.hpp"
+#include "thread_safe_queue.hpp"
+
+using namespace std;
+
+// Measures throughput and push-to-pop latency of every queue for 1P1C, NP1C, 1PNC and NPNC
+// with int, 64-byte struct and std::string payloads.
+// Results are printed as CSV (one line per run) so they can be diffed between queue implementations.
+
+using Clock = chrono::steady_clock;
+
+const size_t capacity = 1024;
+const int n_threads = 4; // N in NP1C, 1PNC and NPNC
+const uint64_t items_per_run = 1 << 20; // divisible by every producer/consumer count
+
+struct Payload64
+{
+    array<char, 64> data{};
+};
+
+template <typename Payload>
+struct PayloadTraits;
+
+template <>
+struct PayloadTraits<int>
+{
+    static constexpr const char* name = "int";
+
+    static int make(uint64_t i)
+    {
+        return static_cast<int>(i);
+    }
+};
+
+template <>
+struct PayloadTraits<Payload64>
+{
+    static constexpr const char* name = "struct64";
+
+    static Payload64 make(uint64_t i)
+    {
+        Payload64 p;
+        p.data[0] = static_cast<char>(i);
+        return p;
+    }
+};
+
+template <>
+struct PayloadTraits<string>
+{
+    static constexpr const char* name = "string";
+
+    static string make(uint64_t i)
+    {
+        return string(32, static_cast<char>('a' + i % 26)); // longer than SSO - allocates
+    }
+};
+
+template <typename Payload>
+struct TimedItem
+{
+    Payload payload;
+    Clock::time_point enqueued;
+};
+
+struct Result
+{
+    double items_per_s;
+    uint64_t p50_ns;
+    uint64_t p99_ns;
+    uint64_t p999_ns;
+};
+
+uint64_t percentile(vector<uint64_t>& samples, double p)
+{
+    const auto nth = samples.begin() + static_cast<ptrdiff_t>(p * (samples.size() - 1));
+    nth_element(samples.begin(), nth, samples.end());
+    return *nth;
+}
+
+template <typename Payload, typename Queue>
+Result run(Queue& q, int producers, int consumers)
+{
+    using Item = TimedItem<Payload>;
+
+    const uint64_t items_per_producer = items_per_run / producers;
+    const uint64_t items_per_consumer = items_per_run / consumers;
+
+    atomic<bool> start{false};
+    vector<vector<uint64_t>> latencies(consumers);
+    vector<thread> threads;
+
+    for (int p = 0; p < producers; ++p)
+        threads.emplace_back([&q, &start, items_per_producer] {
+            while (!start)
+                this_thread::yield();
+
+            for (uint64_t i = 0; i < items_per_producer; ++i)
+                q.push(Item{PayloadTraits<Payload>::make(i), Clock::now()});
+        });
+
+    for (int c = 0; c < consumers; ++c)
+        threads.emplace_back([&q, &start, &samples = latencies[c], items_per_consumer] {
+            samples.reserve(items_per_consumer);
+
+            while (!start)
+                this_thread::yield();
+
+            Item item;
+            for (uint64_t i = 0; i < items_per_consumer; ++i)
+            {
+                q.pop(item);
+                samples.push_back(chrono::duration_cast<chrono::nanoseconds>(Clock::now() - item.enqueued).count());
+            }
+        });
+
+    const auto start_time = Clock::now();
+    start = true;
+
+    for (auto& thd : threads)
+        thd.join();
+
+    const chrono::duration<double> elapsed = Clock::now() - start_time;
+
+    vector<uint64_t> samples;
+    samples.reserve(items_per_run);
+    for (const auto& s : latencies)
+        samples.insert(samples.end(), s.begin(), s.end());
+
+    return Result{items_per_run / elapsed.count(), percentile(samples, 0.5), percentile(samples, 0.99), percentile(samples, 0.999)};
+}
+
+template <typename Payload>
+void report(const string& queue_name, int producers, int consumers, const Result& r)
+{
+    cout << queue_name << ',' << PayloadTraits<Payload>::name << ','
+         << producers << ',' << consumers << ',' << items_per_run << ','
+         << static_cast<uint64_t>(r.items_per_s) << ',' << r.p50_ns << ',' << r.p99_ns << ',' << r.p999_ns << endl;
+}
+
+template <typename Payload>
+void run_all()
+{
+    using Item = TimedItem<Payload>;
+
+    const pair<int, int> configs[] = {{1, 1}, {n_threads, 1}, {1, n_threads}, {n_threads, n_threads}};
+
+    for (const auto& config : configs)
+    {
+        const int producers = config.first;
+        const int consumers = config.second;
+
+        {
+            ThreadSafeQueue<Item> q;
+            report<Payload>("ThreadSafeQueue", producers, consumers, run<Payload>(q, producers, consumers));
+        }
+
+        {
+            BoundedThreadSafeQueue<Item> q{capacity};
+            report<Payload>("BoundedThreadSafeQueue", producers, consumers, run<Payload>(q, producers, consumers));
+        }
+
+        {
+            ShardedThreadSafeQueue<Item> q{static_cast<size_t>(n_threads)};
+            report<Payload>("ShardedThreadSafeQueue", producers, consumers, run<Payload>(q, producers, consumers));
+        }
+
+        {
+            MpmcQueue<Item> q{capacity};
+            report<Payload>("MpmcQueue", producers, consumers, run<Payload>(q, producers, consumers));
+        }
+
+        if (producers == 1 && consumers == 1)
+        {
+            SpscQueue<Item> q{capacity};
+            report<Payload>("SpscQueue", producers, consumers, run<Payload>(q, producers, consumers));
+        }
+    }
+}
+
+int main()
+{
+    cout << "queue,payload,producers,consumers,items,items_per_s,p50_ns,p99_ns,p999_ns" << endl;
+
+    run_all<int>();
+    run_all<Payload64>();
+    run_all<string>();
+}
@@ -0,0 +1,82 @@
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include "spsc_queue.hpp"
+#include "thread_safe_queue.hpp"
+
+using namespace std;
+
+// Pushes count items from one producer thread to one consumer thread.
+// When target_rate > 0 the producer is paced to target_rate items/s.
+// Returns the achieved throughput in items/s.
+template <typename Queue>
+double run_1p1c(Queue& q, uint64_t count, double target_rate)
+{
+    const auto start = chrono::steady_clock::now();
+
+    thread producer{[&q, count, target_rate, start] {
+        for (uint64_t i = 0; i < count; ++i)
+        {
+            if (target_rate > 0 && i % 256 == 0)
+            {
+                const auto scheduled = start + chrono::duration<double>(i / target_rate);
+                while (chrono::steady_clock::now() < scheduled)
+                    this_thread::yield();
+            }
+
+            q.push(i);
+        }
+    }};
+
+    uint64_t item{};
+    uint64_t checksum = 0;
+    for (uint64_t i = 0; i < count; ++i)
+    {
+        q.pop(item);
+        checksum += item;
+    }
+
+    producer.join();
+
+    const chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+
+    if (checksum != count * (count - 1) / 2)
+        cerr << "checksum mismatch!" << endl;
+
+    return count / elapsed.count();
+}
+
+void report(const string& queue_name, double target_rate, double achieved_rate)
+{
+    cout << setw(16) << queue_name
+         << setw(16) << (target_rate > 0 ? to_string(static_cast<uint64_t>(target_rate)) : "max")
+         << setw(16) << static_cast<uint64_t>(achieved_rate) << endl;
+}
+
+int main()
+{
+    const double run_time_s = 0.25;
+    const uint64_t unlimited_count = 5'000'000;
+    const double target_rates[] = {1e6, 1e7, 1e8, 0};
+
+    cout << setw(16) << "queue" << setw(16) << "target items/s" << setw(16) << "items/s" << endl;
+
+    for (auto target_rate : target_rates)
+    {
+        const auto count = target_rate > 0 ? static_cast<uint64_t>(target_rate * run_time_s) : unlimited_count;
+
+        {
+            ThreadSafeQueue<uint64_t> q;
+            report("ThreadSafeQueue", target_rate, run_1p1c(q, count, target_rate));
+        }
+
+        {
+            SpscQueue<uint64_t> q{64 * 1024};
+            report("SpscQueue", target_rate, run_1p1c(q, count, target_rate));
+        }
+    }
+}
@@ -0,0 +1,291 @@
+#ifndef BOUNDED_THREAD_SAFE_QUEUE_HPP
+#define BOUNDED_THREAD_SAFE_QUEUE_HPP
+
+#include <cassert>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "queue_status.hpp"
+
+// Capacity-bounded queue backed by a ring buffer allocated once in the constructor.
+// Producers block (or fail in try_/timed variants) when the queue is full - back-pressure.
+// close() works as in ThreadSafeQueue; it also wakes producers blocked on a full queue (their push throws).
+template <typename T>
+class BoundedThreadSafeQueue
+{
+    using Storage = typename std::aligned_storage<sizeof(T), alignof(T)>::type;
+
+    const size_t capacity_;
+    std::unique_ptr<Storage[]> buffer_;
+    size_t head_ = 0;
+    size_t size_ = 0;
+    bool is_closed_ = false;
+    mutable std::mutex q_mtx_;
+    std::condition_variable cv_not_empty_;
+    std::condition_variable cv_not_full_;
+
+    T* slot(size_t index)
+    {
+        return reinterpret_cast<T*>(&buffer_[index]);
+    }
+
+    bool full_() const
+    {
+        return size_ == capacity_;
+    }
+
+    void throw_if_closed_() const
+    {
+        if (is_closed_)
+            throw std::logic_error("push to closed BoundedThreadSafeQueue");
+    }
+
+    template <typename U>
+    void push_back_(U&& item)
+    {
+        assert(!full_());
+
+        size_t tail = head_ + size_;
+        if (tail >= capacity_)
+            tail -= capacity_;
+
+        new (slot(tail)) T(std::forward<U>(item));
+        ++size_;
+    }
+
+    void pop_front_(T& item)
+    {
+        assert(size_ > 0);
+
+        T* front = slot(head_);
+        item = std::move(*front);
+        front->~T();
+
+        if (++head_ == capacity_)
+            head_ = 0;
+        --size_;
+    }
+
+    template <typename U>
+    void push_(U&& item)
+    {
+        {
+            std::unique_lock<std::mutex> lk{q_mtx_};
+            cv_not_full_.wait(lk, [this] { return !full_() || is_closed_; });
+            throw_if_closed_();
+            push_back_(std::forward<U>(item));
+        }
+
+        cv_not_empty_.notify_one();
+    }
+
+    template <typename U>
+    bool try_push_(U&& item)
+    {
+        {
+            std::unique_lock<std::mutex> lk{q_mtx_, std::try_to_lock};
+            if (!lk || full_() || is_closed_)
+                return false;
+
+            push_back_(std::forward<U>(item));
+        }
+
+        cv_not_empty_.notify_one();
+
+        return true;
+    }
+
+    template <typename U, typename Clock, typename Duration>
+    bool push_until_(U&& item, const std::chrono::time_point<Clock, Duration>& deadline)
+    {
+        {
+            std::unique_lock<std::mutex> lk{q_mtx_};
+            if (!cv_not_full_.wait_until(lk, deadline, [this] { return !full_() || is_closed_; }))
+                return false;
+
+            throw_if_closed_();
+
+            push_back_(std::forward<U>(item));
+        }
+
+        cv_not_empty_.notify_one();
+
+        return true;
+    }
+
+public:
+    explicit BoundedThreadSafeQueue(size_t capacity)
+        : capacity_{capacity}
+        , buffer_{new Storage[capacity]}
+    {
+        assert(capacity > 0);
+    }
+
+    BoundedThreadSafeQueue(const BoundedThreadSafeQueue&) = delete;
+    BoundedThreadSafeQueue& operator=(const BoundedThreadSafeQueue&) = delete;
+
+    ~BoundedThreadSafeQueue()
+    {
+        for (size_t i = 0, index = head_; i < size_; ++i)
+        {
+            slot(index)->~T();
+            if (++index == capacity_)
+                index = 0;
+        }
+    }
+
+    size_t capacity() const
+    {
+        return capacity_;
+    }
+
+    size_t size() const
+    {
+        std::lock_guard<std::mutex> lk{q_mtx_};
+        return size_;
+    }
+
+    bool empty() const
+    {
+        std::lock_guard<std::mutex> lk{q_mtx_};
+        return size_ == 0;
+    }
+
+    bool full() const
+    {
+        std::lock_guard<std::mutex> lk{q_mtx_};
+        return full_();
+    }
+
+    // wakes all waiting producers and consumers; items already queued can still be popped,
+    // then pops return false and pushes throw
+    void close()
+    {
+        {
+            std::lock_guard<std::mutex> lk{q_mtx_};
+            is_closed_ = true;
+        }
+
+        cv_not_empty_.notify_all();
+        cv_not_full_.notify_all();
+    }
+
+    // true when the queue is closed and drained
+    bool done() const
+    {
+        std::lock_guard<std::mutex> lk{q_mtx_};
+        return is_closed_ && size_ == 0;
+    }
+
+    void push(const T& item)
+    {
+        push_(item);
+    }
+
+    void push(T&& item)
+    {
+        push_(std::move(item));
+    }
+
+    bool try_push(const T& item)
+    {
+        return try_push_(item);
+    }
+
+    bool try_push(T&& item)
+    {
+        return try_push_(std::move(item));
+    }
+
+    template <typename Clock, typename Duration>
+    bool push_until(const T& item, const std::chrono::time_point<Clock, Duration>& deadline)
+    {
+        return push_until_(item, deadline);
+    }
+
+    template <typename Clock, typename Duration>
+    bool push_until(T&& item, const std::chrono::time_point<Clock, Duration>& deadline)
+    {
+        return push_until_(std::move(item), deadline);
+    }
+
+    template <typename Rep, typename Period>
+    bool push_for(const T& item, const std::chrono::duration<Rep, Period>& timeout)
+    {
+        return push_until_(item, std::chrono::steady_clock::now() + timeout);
+    }
+
+    template <typename Rep, typename Period>
+    bool push_for(T&& item, const std::chrono::duration<Rep, Period>& timeout)
+    {
+        return push_until_(std::move(item), std::chrono::steady_clock::now() + timeout);
+    }
+
+    bool try_pop(T& item)
+    {
+        {
+            std::unique_lock<std::mutex> lk{q_mtx_, std::try_to_lock};
+            if (!lk || size_ == 0)
+                return false;
+
+            pop_front_(item);
+        }
+
+        cv_not_full_.notify_one();
+
+        return true;
+    }
+
+    // returns false when the queue has been closed and drained
+    bool pop(T& item)
+    {
+        {
+            std::unique_lock<std::mutex> lk{q_mtx_};
+            cv_not_empty_.wait(lk, [this] { return size_ != 0 || is_closed_; });
+
+            if (size_ == 0)
+                return false;
+
+            pop_front_(item);
+        }
+
+        cv_not_full_.notify_one();
+
+        return true;
+    }
+
+    // like ThreadSafeQueue::pop_until - tells a timeout from a closed and drained queue
+    template <typename Clock, typename Duration>
+    QueueStatus pop_until(T& item, const std::chrono::time_point<Clock, Duration>& deadline)
+    {
+        {
+            std::unique_lock<std::mutex> lk{q_mtx_};
+            if (!cv_not_empty_.wait_until(lk, deadline, [this] { return size_ != 0 || is_closed_; }))
+                return QueueStatus::timeout;
+
+            if (size_ == 0)
+                return QueueStatus::closed;
+
+            pop_front_(item);
+        }
+
+        cv_not_full_.notify_one();
+
+        return QueueStatus::success;
+    }
+
+    template <typename Rep, typename Period>
+    QueueStatus pop_for(T& item, const std::chrono::duration<Rep, Period>& timeout)
+    {
+        return pop_until(item, std::chrono::steady_clock::now() + timeout);
+    }
+};
+
+#endif // BOUNDED_THREAD_SAFE_QUEUE_HPP
@@ -0,0 +1,25 @@
+#ifndef CONCURRENCY_UTILS_HPP
+#define CONCURRENCY_UTILS_HPP
+
+#include <atomic>
+#include <cstddef>
+
+// smallest power of 2 >= n - ring buffers use capacities that allow index & mask instead of index % capacity
+inline size_t round_up_to_power_of_2(size_t n)
+{
+    size_t result = 1;
+    while (result < n)
+        result <<= 1;
+    return result;
+}
+
+// stable per-thread number (0, 1, 2, ... in the order the threads first ask for it);
+// spreads threads over lanes/slices so that a thread always uses the same one
+inline size_t thread_token()
+{
+    static std::atomic<size_t> next_token{0};
+    static thread_local const size_t token = next_token++;
+    return token;
+}
+
+#endif // CONCURRENCY_UTILS_HPP
@@ -0,0 +1,244 @@
+#ifndef MPMC_QUEUE_HPP
+#define MPMC_QUEUE_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+#include "concurrency_utils.hpp"
+
+// Lock-free bounded multi-producer/multi-consumer queue (one sequence number per slot).
+// try_push/try_pop never block; push/pop spin, then yield, then park on a condition variable.
+// The spin budget adapts to the workload: it doubles when spinning succeeds and halves when a thread
+// has to park, so spinning is kept only while it pays off.
+// Exposes the ThreadSafeQueue interface, so it can be passed wherever a queue type is a template parameter.
+template <typename T>
+class MpmcQueue
+{
+    static constexpr size_t cache_line_size = 64;
+    static constexpr int initial_spin_count = 64;
+    static constexpr int min_spin_count = 4;
+    static constexpr int max_spin_count = 4096;
+    static constexpr int yield_count = 16;
+
+    using Storage = typename std::aligned_storage<sizeof(T), alignof(T)>::type;
+
+    struct Cell
+    {
+        std::atomic<size_t> sequence;
+        Storage storage;
+    };
+
+    const size_t mask_;
+    std::unique_ptr<Cell[]> buffer_;
+
+    alignas(cache_line_size) std::atomic<size_t> enqueue_pos_{0};
+    alignas(cache_line_size) std::atomic<size_t> dequeue_pos_{0};
+
+    // shared by producers and consumers; a heuristic, so racy updates are fine - written only when it changes
+    alignas(cache_line_size) std::atomic<int> spin_budget_{initial_spin_count};
+
+    alignas(cache_line_size) std::atomic<int> waiting_consumers_{0};
+    std::atomic<int> waiting_producers_{0};
+    std::mutex park_mtx_;
+    std::condition_variable cv_not_empty_;
+    std::condition_variable cv_not_full_;
+
+    static T* item_in(Cell& cell)
+    {
+        return reinterpret_cast<T*>(&cell.storage);
+    }
+
+    template <typename U>
+    bool try_push_(U&& item)
+    {
+        Cell* cell;
+        size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+
+        for (;;)
+        {
+            cell = &buffer_[pos & mask_];
+            const size_t seq = cell->sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos);
+
+            if (diff == 0)
+            {
+                if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            }
+            else if (diff < 0)
+                return false; // full
+            else
+                pos = enqueue_pos_.load(std::memory_order_relaxed);
+        }
+
+        new (item_in(*cell)) T(std::forward<U>(item));
+        cell->sequence.store(pos + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    bool try_pop_(T& item)
+    {
+        Cell* cell;
+        size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+
+        for (;;)
+        {
+            cell = &buffer_[pos & mask_];
+            const size_t seq = cell->sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos + 1);
+
+            if (diff == 0)
+            {
+                if (dequeue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            }
+            else if (diff < 0)
+                return false; // empty
+            else
+                pos = dequeue_pos_.load(std::memory_order_relaxed);
+        }
+
+        T* front = item_in(*cell);
+        item = std::move(*front);
+        front->~T();
+        cell->sequence.store(pos + mask_ + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    template <typename TryOperation>
+    void wait_until_done_(TryOperation try_operation, std::atomic<int>& waiters, std::condition_variable& cv)
+    {
+        const int spin_budget = spin_budget_.load(std::memory_order_relaxed);
+        for (int i = 0; i < spin_budget; ++i)
+            if (try_operation())
+            {
+                if (i > 0 && spin_budget < max_spin_count) // done by spinning - worth spinning longer
+                    spin_budget_.store(std::min(2 * spin_budget, max_spin_count), std::memory_order_relaxed);
+                return;
+            }
+
+        for (int i = 0; i < yield_count; ++i)
+        {
+            if (try_operation())
+                return;
+            std::this_thread::yield();
+        }
+
+        if (spin_budget > min_spin_count) // spinning did not help - waste less next time
+            spin_budget_.store(std::max(spin_budget / 2, min_spin_count), std::memory_order_relaxed);
+
+        std::unique_lock<std::mutex> lk{park_mtx_};
+        waiters.fetch_add(1);
+        std::atomic_thread_fence(std::memory_order_seq_cst); // pairs with the fence in notify_waiter_()
+        cv.wait(lk, try_operation);
+        waiters.fetch_sub(1);
+    }
+
+    void notify_waiter_(std::atomic<int>& waiters, std::condition_variable& cv)
+    {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (waiters.load(std::memory_order_relaxed) == 0)
+            return;
+
+        {
+            std::lock_guard<std::mutex> lk{park_mtx_};
+        }
+        cv.notify_one();
+    }
+
+    template <typename U>
+    bool try_push_and_notify_(U&& item)
+    {
+        if (!try_push_(std::forward<U>(item)))
+            return false;
+
+        notify_waiter_(waiting_consumers_, cv_not_empty_);
+        return true;
+    }
+
+    template <typename U>
+    void push_(U&& item)
+    {
+        wait_until_done_([&] { return try_push_(std::forward<U>(item)); }, waiting_producers_, cv_not_full_);
+        notify_waiter_(waiting_consumers_, cv_not_empty_);
+    }
+
+public:
+    explicit MpmcQueue(size_t capacity)
+        : mask_{round_up_to_power_of_2(capacity < 2 ? 2 : capacity) - 1}
+        , buffer_{new Cell[mask_ + 1]}
+    {
+        for (size_t i = 0; i <= mask_; ++i)
+            buffer_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    MpmcQueue(const MpmcQueue&) = delete;
+    MpmcQueue& operator=(const MpmcQueue&) = delete;
+
+    ~MpmcQueue()
+    {
+        const size_t end = enqueue_pos_.load(std::memory_order_relaxed);
+        for (size_t pos = dequeue_pos_.load(std::memory_order_relaxed); pos != end; ++pos)
+            item_in(buffer_[pos & mask_])->~T();
+    }
+
+    size_t capacity() const
+    {
+        return mask_ + 1;
+    }
+
+    // approximate while other threads push or pop concurrently
+    bool empty() const
+    {
+        return dequeue_pos_.load(std::memory_order_acquire) >= enqueue_pos_.load(std::memory_order_acquire);
+    }
+
+    void push(const T& item)
+    {
+        push_(item);
+    }
+
+    void push(T&& item)
+    {
+        push_(std::move(item));
+    }
+
+    bool try_push(const T& item)
+    {
+        return try_push_and_notify_(item);
+    }
+
+    bool try_push(T&& item)
+    {
+        return try_push_and_notify_(std::move(item));
+    }
+
+    bool try_pop(T& item)
+    {
+        if (!try_pop_(item))
+            return false;
+
+        notify_waiter_(waiting_producers_, cv_not_full_);
+        return true;
+    }
+
+    void pop(T& item)
+    {
+        wait_until_done_([&] { return try_pop_(item); }, waiting_consumers_, cv_not_empty_);
+        notify_waiter_(waiting_producers_, cv_not_full_);
+    }
+};
+
+#endif // MPMC_QUEUE_HPP
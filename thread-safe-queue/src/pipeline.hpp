@@ -0,0 +1,350 @@
+#ifndef PIPELINE_HPP
+#define PIPELINE_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "bounded_thread_safe_queue.hpp"
+
+struct StageStats
+{
+    std::string name;
+    size_t threads = 0;
+    uint64_t items = 0;         // items produced (source) or consumed (transform, sink)
+    double items_per_s = 0.0;
+    size_t queue_depth = 0;     // batches waiting in the stage's input queue
+    size_t queue_high_water = 0;
+};
+
+namespace Detail
+{
+    template <typename T>
+    using BatchQueue = BoundedThreadSafeQueue<std::vector<T>>;
+
+    struct Stage
+    {
+        std::string name;
+        size_t threads;
+        std::function<void()> body;          // copied and run by every worker thread of the stage
+        std::function<void()> close_output;  // called when the last worker has finished
+        std::function<size_t()> input_depth;
+
+        std::atomic<uint64_t> items{0};
+        std::atomic<size_t> input_high_water{0};
+        std::atomic<size_t> active_workers{0};
+        std::atomic<std::chrono::steady_clock::rep> finished_at{0}; // ticks since pipeline start, 0 while running
+
+        Stage(std::string name, size_t threads)
+            : name{std::move(name)}
+            , threads{threads > 0 ? threads : 1}
+        {
+        }
+    };
+}
+
+// Output end of a pipeline stage; pass it to Pipeline::transform/sink to connect the next stage.
+template <typename T>
+class Port
+{
+    friend class Pipeline;
+
+    std::shared_ptr<Detail::BatchQueue<T>> queue_;
+
+    explicit Port(std::shared_ptr<Detail::BatchQueue<T>> queue)
+        : queue_{std::move(queue)}
+    {
+    }
+};
+
+// Collects the items produced by one worker of a stage into batches of batch_size
+// and pushes full batches to the next stage.
+template <typename T>
+class Emitter
+{
+    Detail::BatchQueue<T>& out_;
+    const size_t batch_size_;
+    std::vector<T> batch_;
+    std::atomic<uint64_t>* produced_;
+
+public:
+    Emitter(Detail::BatchQueue<T>& out, size_t batch_size, std::atomic<uint64_t>* produced = nullptr)
+        : out_{out}
+        , batch_size_{batch_size > 0 ? batch_size : 1}
+        , produced_{produced}
+    {
+        batch_.reserve(batch_size_);
+    }
+
+    void push(T item)
+    {
+        batch_.push_back(std::move(item));
+        if (batch_.size() >= batch_size_)
+            flush();
+    }
+
+    void flush()
+    {
+        if (batch_.empty())
+            return;
+
+        if (produced_)
+            produced_->fetch_add(batch_.size(), std::memory_order_relaxed);
+
+        out_.push(std::move(batch_));
+        batch_.clear();
+        batch_.reserve(batch_size_);
+    }
+};
+
+// Linear producer -> transform -> sink pipeline. Stages are connected with BoundedThreadSafeQueue-s
+// (back-pressure) carrying batches of items, and every stage runs on its own worker threads.
+// The first exception thrown by any stage cancels the pipeline and is rethrown from run().
+//
+//   Pipeline p;
+//   auto numbers = p.source<int>("numbers", [](Emitter<int>& out) { for (int i = 0; i < 100; ++i) out.push(i); });
+//   auto squares = p.transform(numbers, "squares", 4, [](int x) { return x * x; });
+//   p.sink(squares, "print", 1, [](int x) { std::cout << x << "\n"; });
+//   p.run();
+class Pipeline
+{
+    using Clock = std::chrono::steady_clock;
+
+    const size_t queue_capacity_;
+    std::vector<std::unique_ptr<Detail::Stage>> stages_;
+    std::vector<std::function<void()>> close_queues_;
+    std::atomic<Clock::rep> start_time_{0};
+
+    std::atomic<bool> is_cancelled_{false};
+    std::mutex exception_mtx_;
+    std::exception_ptr exception_;
+
+    template <typename T>
+    std::shared_ptr<Detail::BatchQueue<T>> make_queue_()
+    {
+        auto queue = std::make_shared<Detail::BatchQueue<T>>(queue_capacity_);
+        close_queues_.push_back([queue] { queue->close(); });
+        return queue;
+    }
+
+    Detail::Stage& add_stage_(std::string name, size_t threads)
+    {
+        stages_.push_back(std::make_unique<Detail::Stage>(std::move(name), threads));
+        return *stages_.back();
+    }
+
+    // a Port feeds exactly one stage - connecting it moves its queue into that stage
+    template <typename T>
+    static void throw_if_connected_(const Port<T>& in)
+    {
+        if (!in.queue_)
+            throw std::logic_error("Port is already connected to a stage");
+    }
+
+    template <typename T>
+    static void connect_input_(Detail::Stage& stage, const Port<T>& in)
+    {
+        auto queue = in.queue_;
+        stage.input_depth = [queue] { return queue->size(); };
+    }
+
+    template <typename T>
+    static void record_depth_(Detail::Stage& stage, Detail::BatchQueue<T>& in)
+    {
+        const size_t depth = in.size();
+        if (depth > stage.input_high_water.load(std::memory_order_relaxed))
+            stage.input_high_water.store(depth, std::memory_order_relaxed);
+    }
+
+    void cancel_(std::exception_ptr e)
+    {
+        {
+            std::lock_guard<std::mutex> lk{exception_mtx_};
+            if (!exception_)
+                exception_ = e;
+        }
+
+        is_cancelled_ = true;
+
+        for (auto& close : close_queues_)
+            close();
+    }
+
+    void run_worker_(Detail::Stage& stage)
+    {
+        try
+        {
+            auto body = stage.body; // every worker gets its own copy of the stage function
+            body();
+        }
+        catch (...)
+        {
+            cancel_(std::current_exception());
+        }
+
+        if (--stage.active_workers == 0)
+        {
+            stage.finished_at = std::max<Clock::rep>(1, Clock::now().time_since_epoch().count() - start_time_);
+            if (stage.close_output)
+                stage.close_output();
+        }
+    }
+
+public:
+    // queue_capacity - number of batches buffered between two stages
+    explicit Pipeline(size_t queue_capacity = 64)
+        : queue_capacity_{queue_capacity}
+    {
+    }
+
+    Pipeline(const Pipeline&) = delete;
+    Pipeline& operator=(const Pipeline&) = delete;
+
+    // f(Emitter<Out>&) is called once and pushes the items
+    template <typename Out, typename F>
+    Port<Out> source(std::string name, F f, size_t batch_size = 1)
+    {
+        auto out = make_queue_<Out>();
+        Detail::Stage& stage = add_stage_(std::move(name), 1);
+
+        stage.body = [out, f, batch_size, &stage]() mutable {
+            Emitter<Out> emitter{*out, batch_size, &stage.items};
+            f(emitter);
+            emitter.flush();
+        };
+        stage.close_output = [out] { out->close(); };
+
+        return Port<Out>{out};
+    }
+
+    // f(In) -> Out is called for every item; each of the stage's threads uses its own copy of f
+    template <typename In, typename F, typename Out = std::decay_t<std::invoke_result_t<F&, In>>>
+    Port<Out> transform(Port<In>& in, std::string name, size_t threads, F f, size_t batch_size = 1)
+    {
+        throw_if_connected_(in);
+
+        auto out = make_queue_<Out>();
+        Detail::Stage& stage = add_stage_(std::move(name), threads);
+        connect_input_(stage, in);
+
+        stage.body = [this, input = std::move(in.queue_), out, f, batch_size, &stage]() mutable {
+            Emitter<Out> emitter{*out, batch_size};
+            std::vector<In> batch;
+
+            while (!is_cancelled_ && input->pop(batch))
+            {
+                record_depth_(stage, *input);
+
+                for (auto& item : batch)
+                    emitter.push(f(std::move(item)));
+
+                stage.items.fetch_add(batch.size(), std::memory_order_relaxed);
+            }
+
+            emitter.flush();
+        };
+        stage.close_output = [out] { out->close(); };
+
+        return Port<Out>{out};
+    }
+
+    // f(In) is called for every item; each of the stage's threads uses its own copy of f
+    template <typename In, typename F>
+    void sink(Port<In>& in, std::string name, size_t threads, F f)
+    {
+        throw_if_connected_(in);
+
+        Detail::Stage& stage = add_stage_(std::move(name), threads);
+        connect_input_(stage, in);
+
+        stage.body = [this, input = std::move(in.queue_), f, &stage]() mutable {
+            std::vector<In> batch;
+
+            while (!is_cancelled_ && input->pop(batch))
+            {
+                record_depth_(stage, *input);
+
+                for (auto& item : batch)
+                    f(std::move(item));
+
+                stage.items.fetch_add(batch.size(), std::memory_order_relaxed);
+            }
+        };
+    }
+
+    // runs all stages and blocks until the sink has consumed everything;
+    // rethrows the first exception thrown by a stage
+    void run()
+    {
+        start_time_ = Clock::now().time_since_epoch().count();
+
+        std::vector<std::thread> threads;
+
+        for (auto& stage : stages_)
+            stage->active_workers = stage->threads;
+
+        try
+        {
+            for (auto& stage : stages_)
+                for (size_t i = 0; i < stage->threads; ++i)
+                    threads.emplace_back([this, &s = *stage] { run_worker_(s); });
+        }
+        catch (...)
+        {
+            // stop the workers already started - destroying joinable threads would terminate the process
+            cancel_(std::current_exception());
+
+            for (auto& thd : threads)
+                thd.join();
+
+            throw;
+        }
+
+        for (auto& thd : threads)
+            thd.join();
+
+        if (exception_)
+            std::rethrow_exception(exception_);
+    }
+
+    // can be called while run() is in progress, e.g. from a monitoring thread
+    std::vector<StageStats> stats() const
+    {
+        const auto start = start_time_.load();
+        const auto now = Clock::now().time_since_epoch().count() - start;
+
+        std::vector<StageStats> result;
+        for (const auto& stage : stages_)
+        {
+            StageStats s;
+            s.name = stage->name;
+            s.threads = stage->threads;
+            s.items = stage->items;
+
+            const auto finished_at = stage->finished_at.load();
+            const Clock::duration elapsed{start == 0 ? 0 : (finished_at != 0 ? finished_at : now)};
+            if (elapsed.count() > 0)
+                s.items_per_s = s.items / std::chrono::duration<double>(elapsed).count();
+
+            s.queue_depth = stage->input_depth ? stage->input_depth() : 0;
+            s.queue_high_water = stage->input_high_water;
+            result.push_back(s);
+        }
+
+        return result;
+    }
+};
+
+#endif // PIPELINE_HPP
@@ -0,0 +1,255 @@
+#ifndef PRIORITY_THREAD_SAFE_QUEUE_HPP
+#define PRIORITY_THREAD_SAFE_QUEUE_HPP
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <stdexcept>
+#include <utility>
+
+#include "queue_status.hpp"
+
+// Concurrent queue with a fixed number of priority bands (0 is the highest priority).
+// Every band is a FIFO sub-queue with its own mutex on its own cache line, so producers of different
+// priorities do not contend - there is no queue-wide counter either: emptiness is read from the bands' own sizes.
+// Consumers take the oldest item of the highest non-empty band.
+// Blocking/try semantics follow ThreadSafeQueue (including close()).
+template <typename T>
+class PriorityThreadSafeQueue
+{
+    static constexpr size_t cache_line_size = 64;
+
+    struct alignas(cache_line_size) Band
+    {
+        std::mutex mtx;
+        std::queue<T> q;
+        std::atomic<size_t> size{0}; // changed under mtx
+    };
+
+    const size_t no_of_bands_;
+    std::unique_ptr<Band[]> bands_;
+
+    std::atomic<bool> is_closed_{false};
+
+    alignas(cache_line_size) std::atomic<int> waiting_consumers_{0};
+    std::mutex park_mtx_;
+    std::condition_variable cv_not_empty_;
+
+    Band& band(size_t priority)
+    {
+        if (priority >= no_of_bands_)
+            throw std::out_of_range("invalid priority of PriorityThreadSafeQueue item");
+
+        return bands_[priority];
+    }
+
+    void throw_if_closed_() const
+    {
+        if (is_closed_)
+            throw std::logic_error("push to closed PriorityThreadSafeQueue");
+    }
+
+    template <typename U>
+    void push_back_(Band& b, U&& item)
+    {
+        b.q.push(std::forward<U>(item));
+        b.size.fetch_add(1, std::memory_order_seq_cst); // pairs with has_items_() of a parking consumer
+    }
+
+    void notify_consumer_()
+    {
+        if (waiting_consumers_.load(std::memory_order_seq_cst) > 0)
+        {
+            std::lock_guard<std::mutex> lk{park_mtx_};
+            cv_not_empty_.notify_one();
+        }
+    }
+
+    template <typename U>
+    void push_(U&& item, size_t priority)
+    {
+        Band& b = band(priority);
+        {
+            std::lock_guard<std::mutex> lk{b.mtx};
+            throw_if_closed_();
+            push_back_(b, std::forward<U>(item));
+        }
+
+        notify_consumer_();
+    }
+
+    template <typename U>
+    bool try_push_(U&& item, size_t priority)
+    {
+        Band& b = band(priority);
+        {
+            std::unique_lock<std::mutex> lk{b.mtx, std::try_to_lock};
+            if (!lk || is_closed_)
+                return false;
+
+            push_back_(b, std::forward<U>(item));
+        }
+
+        notify_consumer_();
+
+        return true;
+    }
+
+    // takes the oldest item of the highest non-empty band; when is_blocking is false, gives up
+    // (returns false) if that band is locked by another thread
+    bool pop_front_(T& item, bool is_blocking)
+    {
+        for (size_t i = 0; i < no_of_bands_; ++i)
+        {
+            Band& b = bands_[i];
+            if (b.size.load(std::memory_order_relaxed) == 0)
+                continue;
+
+            std::unique_lock<std::mutex> lk{b.mtx, std::defer_lock};
+            if (is_blocking)
+                lk.lock();
+            else if (!lk.try_lock())
+                return false; // skipping the band could return a lower priority item first
+
+            if (b.q.empty())
+                continue;
+
+            item = std::move(b.q.front());
+            b.q.pop();
+            b.size.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+
+        return false;
+    }
+
+    bool has_items_() const
+    {
+        for (size_t i = 0; i < no_of_bands_; ++i)
+            if (bands_[i].size.load(std::memory_order_seq_cst) > 0)
+                return true;
+
+        return false;
+    }
+
+    // wait(lk, is_ready) blocks on cv_not_empty_ and returns false on timeout
+    template <typename Wait>
+    QueueStatus pop_(T& item, Wait wait)
+    {
+        for (;;)
+        {
+            if (pop_front_(item, true))
+                return QueueStatus::success;
+
+            std::unique_lock<std::mutex> lk{park_mtx_};
+            waiting_consumers_.fetch_add(1, std::memory_order_seq_cst);
+            const bool is_ready = wait(lk, [this] { return has_items_() || is_closed_; });
+            waiting_consumers_.fetch_sub(1, std::memory_order_relaxed);
+
+            if (!is_ready)
+                return QueueStatus::timeout;
+
+            if (is_closed_ && empty())
+                return QueueStatus::closed;
+        }
+    }
+
+public:
+    explicit PriorityThreadSafeQueue(size_t no_of_priorities = 3)
+        : no_of_bands_{no_of_priorities}
+        , bands_{new Band[no_of_priorities]}
+    {
+        if (no_of_priorities == 0)
+            throw std::invalid_argument("PriorityThreadSafeQueue needs at least one priority");
+    }
+
+    PriorityThreadSafeQueue(const PriorityThreadSafeQueue&) = delete;
+    PriorityThreadSafeQueue& operator=(const PriorityThreadSafeQueue&) = delete;
+
+    size_t no_of_priorities() const
+    {
+        return no_of_bands_;
+    }
+
+    bool empty() const
+    {
+        return !has_items_();
+    }
+
+    // wakes all waiting consumers; items already queued can still be popped,
+    // then pops return false and pushes throw
+    void close()
+    {
+        for (size_t i = 0; i < no_of_bands_; ++i)
+        {
+            std::lock_guard<std::mutex> lk{bands_[i].mtx};
+            is_closed_ = true;
+        }
+
+        std::lock_guard<std::mutex> lk{park_mtx_};
+        cv_not_empty_.notify_all();
+    }
+
+    // true when the queue is closed and drained
+    bool done() const
+    {
+        return is_closed_ && empty();
+    }
+
+    void push(const T& item, size_t priority)
+    {
+        push_(item, priority);
+    }
+
+    void push(T&& item, size_t priority)
+    {
+        push_(std::move(item), priority);
+    }
+
+    bool try_push(const T& item, size_t priority)
+    {
+        return try_push_(item, priority);
+    }
+
+    bool try_push(T&& item, size_t priority)
+    {
+        return try_push_(std::move(item), priority);
+    }
+
+    // never blocks (like ThreadSafeQueue::try_pop): returns false when the queue is empty or when
+    // the band of the next item is locked by another thread; takes the oldest item of the highest non-empty band
+    bool try_pop(T& item)
+    {
+        return pop_front_(item, false);
+    }
+
+    // returns false when the queue has been closed and drained
+    bool pop(T& item)
+    {
+        return pop_(item, [this](std::unique_lock<std::mutex>& lk, auto is_ready) {
+            cv_not_empty_.wait(lk, is_ready);
+            return true;
+        }) == QueueStatus::success;
+    }
+
+    // like ThreadSafeQueue::pop_until - tells a timeout from a closed and drained queue
+    template <typename Clock, typename Duration>
+    QueueStatus pop_until(T& item, const std::chrono::time_point<Clock, Duration>& deadline)
+    {
+        return pop_(item, [this, &deadline](std::unique_lock<std::mutex>& lk, auto is_ready) {
+            return cv_not_empty_.wait_until(lk, deadline, is_ready);
+        });
+    }
+
+    template <typename Rep, typename Period>
+    QueueStatus pop_for(T& item, const std::chrono::duration<Rep, Period>& timeout)
+    {
+        return pop_until(item, std::chrono::steady_clock::now() + timeout);
+    }
+};
+
+#endif // PRIORITY_THREAD_SAFE_QUEUE_HPP
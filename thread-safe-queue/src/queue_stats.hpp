@@ -0,0 +1,189 @@
+#ifndef QUEUE_STATS_HPP
+#define QUEUE_STATS_HPP
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <queue>
+
+// Histogram of durations in power-of-2 nanosecond buckets: bucket i counts samples in [2^i, 2^(i+1)) ns
+// (bucket 0 also counts 0 ns, the last bucket everything above).
+struct DurationHistogram
+{
+    static constexpr size_t bucket_count = 40;
+
+    std::array<uint64_t, bucket_count> buckets{};
+
+    static size_t bucket_of(uint64_t ns)
+    {
+        size_t bucket = 0;
+        while (ns > 1 && bucket < bucket_count - 1)
+        {
+            ns >>= 1;
+            ++bucket;
+        }
+        return bucket;
+    }
+
+    uint64_t count() const
+    {
+        uint64_t total = 0;
+        for (auto n : buckets)
+            total += n;
+        return total;
+    }
+
+    // upper bound (in ns) of the bucket containing the p-th quantile, p in [0, 1]
+    uint64_t percentile(double p) const
+    {
+        const uint64_t total = count();
+        if (total == 0)
+            return 0;
+
+        const auto rank = static_cast<uint64_t>(p * (total - 1)) + 1;
+        uint64_t seen = 0;
+        for (size_t i = 0; i < bucket_count; ++i)
+        {
+            seen += buckets[i];
+            if (seen >= rank)
+                return uint64_t{2} << i;
+        }
+
+        return uint64_t{2} << (bucket_count - 1);
+    }
+};
+
+struct QueueStatsSnapshot
+{
+    DurationHistogram lock_wait;     // time spent acquiring the queue mutex
+    DurationHistogram latency;       // time from push to pop of an item
+    size_t high_water_mark = 0;      // maximum number of queued items
+    uint64_t try_lock_failures = 0;  // try_push/try_pop calls that failed because the mutex was taken
+    uint64_t wakeups = 0;            // returns of consumers from a condition variable wait
+    uint64_t spurious_wakeups = 0;   // wake-ups that found the queue empty and open (timeouts included)
+};
+
+// Default ThreadSafeQueue statistics policy - every hook is empty, so nothing is measured or stored.
+struct NoQueueStats
+{
+    struct TimePoint
+    {
+    };
+
+    TimePoint now() const
+    {
+        return {};
+    }
+
+    void lock_acquired(TimePoint)
+    {
+    }
+
+    void try_lock_failed()
+    {
+    }
+
+    void enqueued(size_t)
+    {
+    }
+
+    void dequeued()
+    {
+    }
+
+    void woken(bool)
+    {
+    }
+};
+
+// ThreadSafeQueue statistics policy that records everything in QueueStatsSnapshot.
+// The hooks are called by the queue (enqueued/dequeued with its mutex held); snapshot()
+// only reads relaxed atomics, so a monitoring thread can call it at any time without the queue lock.
+class QueueStats
+{
+    using Clock = std::chrono::steady_clock;
+
+    class AtomicHistogram
+    {
+        std::array<std::atomic<uint64_t>, DurationHistogram::bucket_count> buckets_{};
+
+    public:
+        void record(Clock::duration d)
+        {
+            const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(d).count();
+            buckets_[DurationHistogram::bucket_of(ns > 0 ? ns : 0)].fetch_add(1, std::memory_order_relaxed);
+        }
+
+        DurationHistogram snapshot() const
+        {
+            DurationHistogram result;
+            for (size_t i = 0; i < result.bucket_count; ++i)
+                result.buckets[i] = buckets_[i].load(std::memory_order_relaxed);
+            return result;
+        }
+    };
+
+    AtomicHistogram lock_wait_;
+    AtomicHistogram latency_;
+    std::atomic<size_t> high_water_mark_{0};
+    std::atomic<uint64_t> try_lock_failures_{0};
+    std::atomic<uint64_t> wakeups_{0};
+    std::atomic<uint64_t> spurious_wakeups_{0};
+
+    std::queue<Clock::time_point> enqueue_times_; // guarded by the queue mutex
+
+public:
+    using TimePoint = Clock::time_point;
+
+    TimePoint now() const
+    {
+        return Clock::now();
+    }
+
+    void lock_acquired(TimePoint start)
+    {
+        lock_wait_.record(now() - start);
+    }
+
+    void try_lock_failed()
+    {
+        try_lock_failures_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void enqueued(size_t size)
+    {
+        enqueue_times_.push(now());
+
+        if (size > high_water_mark_.load(std::memory_order_relaxed))
+            high_water_mark_.store(size, std::memory_order_relaxed);
+    }
+
+    void dequeued()
+    {
+        latency_.record(now() - enqueue_times_.front());
+        enqueue_times_.pop();
+    }
+
+    void woken(bool has_work)
+    {
+        wakeups_.fetch_add(1, std::memory_order_relaxed);
+        if (!has_work)
+            spurious_wakeups_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    QueueStatsSnapshot snapshot() const
+    {
+        QueueStatsSnapshot result;
+        result.lock_wait = lock_wait_.snapshot();
+        result.latency = latency_.snapshot();
+        result.high_water_mark = high_water_mark_.load(std::memory_order_relaxed);
+        result.try_lock_failures = try_lock_failures_.load(std::memory_order_relaxed);
+        result.wakeups = wakeups_.load(std::memory_order_relaxed);
+        result.spurious_wakeups = spurious_wakeups_.load(std::memory_order_relaxed);
+        return result;
+    }
+};
+
+#endif // QUEUE_STATS_HPP
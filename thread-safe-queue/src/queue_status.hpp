@@ -0,0 +1,12 @@
+#ifndef QUEUE_STATUS_HPP
+#define QUEUE_STATUS_HPP
+
+// result of the timed pops of all queues: timeout and closed (and drained) are told apart
+enum class QueueStatus
+{
+    success,
+    timeout,
+    closed
+};
+
+#endif // QUEUE_STATUS_HPP
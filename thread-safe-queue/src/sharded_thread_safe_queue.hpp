@@ -0,0 +1,223 @@
+#ifndef SHARDED_THREAD_SAFE_QUEUE_HPP
+#define SHARDED_THREAD_SAFE_QUEUE_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+#include "concurrency_utils.hpp"
+
+// Multi-lane queue: every producer thread is assigned to one of the lanes (each with its own mutex
+// on its own cache line), so producers on different lanes never contend.
+// Consumers start at their own lane and take from the other lanes when it is empty.
+// Items pushed by one producer are popped in FIFO order; there is no ordering between producers.
+// Blocking/try semantics follow ThreadSafeQueue (including close()).
+template <typename T>
+class ShardedThreadSafeQueue
+{
+    static constexpr size_t cache_line_size = 64;
+
+    struct alignas(cache_line_size) Lane
+    {
+        std::mutex mtx;
+        std::queue<T> q;
+        std::atomic<size_t> size{0};
+    };
+
+    const size_t no_of_lanes_;
+    std::unique_ptr<Lane[]> lanes_;
+    std::atomic<bool> is_closed_{false};
+
+    alignas(cache_line_size) std::atomic<int> waiting_consumers_{0};
+    std::mutex park_mtx_;
+    std::condition_variable cv_not_empty_;
+
+    Lane& own_lane()
+    {
+        return lanes_[thread_token() % no_of_lanes_];
+    }
+
+    void throw_if_closed_() const
+    {
+        if (is_closed_)
+            throw std::logic_error("push to closed ShardedThreadSafeQueue");
+    }
+
+    template <typename U>
+    void push_back_(Lane& lane, U&& item)
+    {
+        lane.q.push(std::forward<U>(item));
+        lane.size.fetch_add(1, std::memory_order_seq_cst);
+    }
+
+    void notify_consumer_()
+    {
+        if (waiting_consumers_.load(std::memory_order_seq_cst) > 0)
+        {
+            std::lock_guard<std::mutex> lk{park_mtx_};
+            cv_not_empty_.notify_one();
+        }
+    }
+
+    template <typename U>
+    void push_(U&& item)
+    {
+        Lane& lane = own_lane();
+        {
+            std::lock_guard<std::mutex> lk{lane.mtx};
+            throw_if_closed_();
+            push_back_(lane, std::forward<U>(item));
+        }
+
+        notify_consumer_();
+    }
+
+    template <typename U>
+    bool try_push_(U&& item)
+    {
+        Lane& lane = own_lane();
+        {
+            std::unique_lock<std::mutex> lk{lane.mtx, std::try_to_lock};
+            if (!lk || is_closed_)
+                return false;
+
+            push_back_(lane, std::forward<U>(item));
+        }
+
+        notify_consumer_();
+
+        return true;
+    }
+
+    bool has_items_() const
+    {
+        for (size_t i = 0; i < no_of_lanes_; ++i)
+            if (lanes_[i].size.load(std::memory_order_seq_cst) > 0)
+                return true;
+
+        return false;
+    }
+
+    // takes the oldest item of the first non-empty lane, starting at the calling thread's lane;
+    // when is_blocking is false, lanes locked by another thread are skipped
+    bool pop_front_(T& item, bool is_blocking)
+    {
+        const size_t start = thread_token();
+
+        for (size_t i = 0; i < no_of_lanes_; ++i)
+        {
+            Lane& lane = lanes_[(start + i) % no_of_lanes_];
+            if (lane.size.load(std::memory_order_relaxed) == 0)
+                continue;
+
+            std::unique_lock<std::mutex> lk{lane.mtx, std::defer_lock};
+            if (is_blocking)
+                lk.lock();
+            else if (!lk.try_lock())
+                continue;
+
+            if (lane.q.empty())
+                continue;
+
+            item = std::move(lane.q.front());
+            lane.q.pop();
+            lane.size.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+
+        return false;
+    }
+
+public:
+    explicit ShardedThreadSafeQueue(size_t no_of_lanes = std::thread::hardware_concurrency())
+        : no_of_lanes_{no_of_lanes > 0 ? no_of_lanes : 1}
+        , lanes_{new Lane[no_of_lanes_]}
+    {
+    }
+
+    ShardedThreadSafeQueue(const ShardedThreadSafeQueue&) = delete;
+    ShardedThreadSafeQueue& operator=(const ShardedThreadSafeQueue&) = delete;
+
+    size_t no_of_lanes() const
+    {
+        return no_of_lanes_;
+    }
+
+    bool empty() const
+    {
+        return !has_items_();
+    }
+
+    // wakes all waiting consumers; items already queued can still be popped,
+    // then pops return false and pushes throw
+    void close()
+    {
+        for (size_t i = 0; i < no_of_lanes_; ++i)
+        {
+            std::lock_guard<std::mutex> lk{lanes_[i].mtx};
+            is_closed_ = true;
+        }
+
+        std::lock_guard<std::mutex> lk{park_mtx_};
+        cv_not_empty_.notify_all();
+    }
+
+    // true when the queue is closed and drained
+    bool done() const
+    {
+        return is_closed_ && empty();
+    }
+
+    void push(const T& item)
+    {
+        push_(item);
+    }
+
+    void push(T&& item)
+    {
+        push_(std::move(item));
+    }
+
+    bool try_push(const T& item)
+    {
+        return try_push_(item);
+    }
+
+    bool try_push(T&& item)
+    {
+        return try_push_(std::move(item));
+    }
+
+    // never blocks (like ThreadSafeQueue::try_pop): lanes locked by another thread are skipped,
+    // so it returns false when every lane is empty or busy; starts at the calling thread's lane
+    bool try_pop(T& item)
+    {
+        return pop_front_(item, false);
+    }
+
+    // returns false when the queue has been closed and drained
+    bool pop(T& item)
+    {
+        for (;;)
+        {
+            if (pop_front_(item, true))
+                return true;
+
+            std::unique_lock<std::mutex> lk{park_mtx_};
+            waiting_consumers_.fetch_add(1, std::memory_order_seq_cst);
+            cv_not_empty_.wait(lk, [this] { return has_items_() || is_closed_; });
+            waiting_consumers_.fetch_sub(1, std::memory_order_relaxed);
+
+            if (is_closed_ && empty())
+                return false;
+        }
+    }
+};
+
+#endif // SHARDED_THREAD_SAFE_QUEUE_HPP
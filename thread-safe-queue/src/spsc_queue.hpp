@@ -0,0 +1,140 @@
+#ifndef SPSC_QUEUE_HPP
+#define SPSC_QUEUE_HPP
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+#include "concurrency_utils.hpp"
+
+// Wait-free single-producer/single-consumer ring queue.
+// Exactly one thread may call push/try_push and exactly one thread may call pop/try_pop.
+// Blocking push/pop spin (yielding) while the queue is full/empty.
+template <typename T>
+class SpscQueue
+{
+    static constexpr size_t cache_line_size = 64;
+
+    using Storage = typename std::aligned_storage<sizeof(T), alignof(T)>::type;
+
+    const size_t mask_;
+    std::unique_ptr<Storage[]> buffer_;
+
+    // consumer side: head_ is written by the consumer, cached_tail_ is its private copy of tail_
+    alignas(cache_line_size) std::atomic<size_t> head_{0};
+    size_t cached_tail_ = 0;
+
+    // producer side: tail_ is written by the producer, cached_head_ is its private copy of head_
+    alignas(cache_line_size) std::atomic<size_t> tail_{0};
+    size_t cached_head_ = 0;
+
+    T* slot(size_t index)
+    {
+        return reinterpret_cast<T*>(&buffer_[index & mask_]);
+    }
+
+    template <typename U>
+    bool try_push_(U&& item)
+    {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+
+        if (tail - cached_head_ > mask_)
+        {
+            cached_head_ = head_.load(std::memory_order_acquire);
+            if (tail - cached_head_ > mask_)
+                return false;
+        }
+
+        new (slot(tail)) T(std::forward<U>(item));
+        tail_.store(tail + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    template <typename U>
+    void push_(U&& item)
+    {
+        while (!try_push_(std::forward<U>(item)))
+            std::this_thread::yield();
+    }
+
+public:
+    explicit SpscQueue(size_t capacity)
+        : mask_{round_up_to_power_of_2(capacity) - 1}
+        , buffer_{new Storage[mask_ + 1]}
+    {
+        assert(capacity > 0);
+    }
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    ~SpscQueue()
+    {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        for (size_t index = head_.load(std::memory_order_relaxed); index != tail; ++index)
+            slot(index)->~T();
+    }
+
+    size_t capacity() const
+    {
+        return mask_ + 1;
+    }
+
+    bool empty() const
+    {
+        return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire);
+    }
+
+    void push(const T& item)
+    {
+        push_(item);
+    }
+
+    void push(T&& item)
+    {
+        push_(std::move(item));
+    }
+
+    bool try_push(const T& item)
+    {
+        return try_push_(item);
+    }
+
+    bool try_push(T&& item)
+    {
+        return try_push_(std::move(item));
+    }
+
+    bool try_pop(T& item)
+    {
+        const size_t head = head_.load(std::memory_order_relaxed);
+
+        if (head == cached_tail_)
+        {
+            cached_tail_ = tail_.load(std::memory_order_acquire);
+            if (head == cached_tail_)
+                return false;
+        }
+
+        T* front = slot(head);
+        item = std::move(*front);
+        front->~T();
+        head_.store(head + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    void pop(T& item)
+    {
+        while (!try_pop(item))
+            std::this_thread::yield();
+    }
+};
+
+#endif // SPSC_QUEUE_HPP
@@ -0,0 +1,103 @@
+#ifndef TASK_HPP
+#define TASK_HPP
+
+#include <cstddef>
+#include <future>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+// Move-only type-erased void() callable; unlike std::function it can hold a std::packaged_task.
+class Task
+{
+    struct Concept
+    {
+        virtual ~Concept() = default;
+        virtual void call() = 0;
+    };
+
+    template <typename F>
+    struct Model : Concept
+    {
+        F f;
+
+        explicit Model(F&& f)
+            : f(std::move(f))
+        {
+        }
+
+        void call() override
+        {
+            f();
+        }
+    };
+
+    std::unique_ptr<Concept> impl_;
+
+public:
+    Task() = default;
+
+    template <typename F, typename = std::enable_if_t<!std::is_same<std::decay_t<F>, Task>::value>>
+    Task(F&& f)
+        : impl_(std::make_unique<Model<std::decay_t<F>>>(std::decay_t<F>(std::forward<F>(f))))
+    {
+    }
+
+    Task(Task&&) noexcept = default;
+    Task& operator=(Task&&) noexcept = default;
+
+    explicit operator bool() const noexcept
+    {
+        return impl_ != nullptr;
+    }
+
+    void operator()()
+    {
+        impl_->call();
+    }
+};
+
+namespace Detail
+{
+    // stores decayed copies of a callable and its arguments; the arguments are moved in on the (single) call
+    template <typename F, typename... Args>
+    class BoundCall
+    {
+        std::tuple<std::decay_t<F>, std::decay_t<Args>...> call_;
+
+        template <size_t... Is>
+        decltype(auto) invoke_(std::index_sequence<Is...>)
+        {
+            return std::move(std::get<0>(call_))(std::move(std::get<Is + 1>(call_))...);
+        }
+
+    public:
+        template <typename Fn, typename... As>
+        explicit BoundCall(Fn&& f, As&&... args)
+            : call_(std::forward<Fn>(f), std::forward<As>(args)...)
+        {
+        }
+
+        decltype(auto) operator()()
+        {
+            return invoke_(std::index_sequence_for<Args...>{});
+        }
+    };
+}
+
+template <typename F, typename... Args>
+using TaskResult = decltype(std::declval<std::decay_t<F>>()(std::declval<std::decay_t<Args>>()...));
+
+// wraps f(args...) into a Task; the result (or exception) is delivered through the returned future
+template <typename F, typename... Args>
+std::pair<Task, std::future<TaskResult<F, Args...>>> make_task(F&& f, Args&&... args)
+{
+    std::packaged_task<TaskResult<F, Args...>()> pt{
+        Detail::BoundCall<F, Args...>{std::forward<F>(f), std::forward<Args>(args)...}};
+    auto result = pt.get_future();
+
+    return {Task{std::move(pt)}, std::move(result)};
+}
+
+#endif // TASK_HPP
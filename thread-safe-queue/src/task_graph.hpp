@@ -0,0 +1,453 @@
+#ifndef TASK_GRAPH_HPP
+#define TASK_GRAPH_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "task.hpp"
+#include "thread_pool.hpp"
+
+template <typename T>
+class TaskFuture;
+
+namespace Detail
+{
+    template <typename T>
+    using Stored = std::conditional_t<std::is_void<T>::value, std::monostate, T>;
+
+    // result slot shared by the producing task and everybody waiting for it
+    template <typename T>
+    class SharedState
+    {
+        std::mutex mtx_;
+        std::condition_variable cv_ready_;
+        bool is_ready_ = false;
+        std::optional<Stored<T>> value_;
+        std::exception_ptr exception_;
+        std::vector<std::function<void()>> continuations_;
+
+        // a result is set exactly once; every continuation runs even if an earlier one throws,
+        // and the first exception of a continuation is rethrown at the end
+        template <typename Set>
+        void complete_(Set set)
+        {
+            std::vector<std::function<void()>> continuations;
+            {
+                std::lock_guard<std::mutex> lk{mtx_};
+                if (is_ready_)
+                    throw std::logic_error("task result already set");
+
+                set();
+                is_ready_ = true;
+                continuations.swap(continuations_);
+            }
+            cv_ready_.notify_all();
+
+            std::exception_ptr first_exception;
+            for (auto& c : continuations)
+                try
+                {
+                    c();
+                }
+                catch (...)
+                {
+                    if (!first_exception)
+                        first_exception = std::current_exception();
+                }
+
+            if (first_exception)
+                std::rethrow_exception(first_exception);
+        }
+
+    public:
+        ThreadPool& pool;
+
+        explicit SharedState(ThreadPool& pool)
+            : pool{pool}
+        {
+        }
+
+        void set_value(Stored<T> value)
+        {
+            complete_([&] { value_.emplace(std::move(value)); });
+        }
+
+        void set_exception(std::exception_ptr e)
+        {
+            complete_([&] { exception_ = std::move(e); });
+        }
+
+        // f is called once the result is set - right away (in the calling thread) when it already is,
+        // otherwise by the thread that sets it; it must be short and must not throw
+        void on_ready(std::function<void()> f)
+        {
+            {
+                std::lock_guard<std::mutex> lk{mtx_};
+                if (!is_ready_)
+                {
+                    continuations_.push_back(std::move(f));
+                    return;
+                }
+            }
+
+            f();
+        }
+
+        bool is_ready()
+        {
+            std::lock_guard<std::mutex> lk{mtx_};
+            return is_ready_;
+        }
+
+        void wait()
+        {
+            std::unique_lock<std::mutex> lk{mtx_};
+            cv_ready_.wait(lk, [this] { return is_ready_; });
+        }
+
+        // valid only when ready
+        const std::exception_ptr& exception() const
+        {
+            return exception_;
+        }
+
+        const Stored<T>& value() const
+        {
+            return *value_;
+        }
+    };
+
+    // arguments a dependency passes to the task: its value, or nothing for void tasks
+    template <typename T>
+    auto value_tuple(const SharedState<T>& state)
+    {
+        if constexpr (std::is_void<T>::value)
+            return std::tuple<>{};
+        else
+            return std::tuple<T>{state.value()};
+    }
+
+    template <typename F, typename... Ts>
+    using TaskGraphResult = decltype(std::apply(std::declval<F&>(), std::tuple_cat(value_tuple(std::declval<const SharedState<Ts>&>())...)));
+
+    // only f runs inside the try block - an exception thrown by a continuation of the result
+    // must not be taken for the task's own exception and set the result a second time
+    template <typename R, typename F, typename Args>
+    void run_into(SharedState<R>& result, F& f, Args&& args)
+    {
+        std::optional<Stored<R>> value;
+        try
+        {
+            if constexpr (std::is_void<R>::value)
+            {
+                std::apply(f, std::forward<Args>(args));
+                value.emplace();
+            }
+            else
+                value.emplace(std::apply(f, std::forward<Args>(args)));
+        }
+        catch (...)
+        {
+            result.set_exception(std::current_exception());
+            return;
+        }
+
+        result.set_value(std::move(*value));
+    }
+
+    // Runs f(values of deps...) on the pool once all dependencies are ready. Nothing blocks while waiting:
+    // the last dependency to complete schedules the task. If a dependency failed, f is not run and
+    // the first exception (in argument order) is passed on to the result. So is the exception of a failed
+    // pool.post() (the pool's queue is already closed), so continuations scheduling the task never throw.
+    template <typename F, typename... Ts>
+    TaskFuture<TaskGraphResult<F, Ts...>> schedule(ThreadPool& pool, F f, std::shared_ptr<SharedState<Ts>>... deps)
+    {
+        using R = TaskGraphResult<F, Ts...>;
+
+        auto result = std::make_shared<SharedState<R>>(pool);
+
+        auto run = std::make_shared<std::function<void()>>();
+        *run = [&pool, result, f = std::make_shared<F>(std::move(f)), deps...] {
+            std::exception_ptr e;
+            ((e = e ? e : deps->exception()), ...);
+            if (e)
+            {
+                result->set_exception(e);
+                return;
+            }
+
+            try
+            {
+                pool.post([result, f, deps...] { run_into(*result, *f, std::tuple_cat(value_tuple(*deps)...)); });
+            }
+            catch (...)
+            {
+                result->set_exception(std::current_exception());
+            }
+        };
+
+        if constexpr (sizeof...(Ts) == 0)
+            (*run)();
+        else
+        {
+            auto pending = std::make_shared<std::atomic<size_t>>(sizeof...(Ts));
+            (deps->on_ready([pending, run] {
+                if (pending->fetch_sub(1) == 1)
+                    (*run)();
+            }),
+                ...);
+        }
+
+        return TaskFuture<R>{result};
+    }
+}
+
+// Result of a task in a task graph. Unlike std::future it can be shared by many consumers
+// and extended with continuations that run when the result is ready, without blocking any thread.
+template <typename T>
+class TaskFuture
+{
+    template <typename>
+    friend class TaskFuture;
+    friend class TaskGraph;
+
+    template <typename F, typename... Ts>
+    friend TaskFuture<Detail::TaskGraphResult<F, Ts...>> Detail::schedule(ThreadPool&, F, std::shared_ptr<Detail::SharedState<Ts>>...);
+
+    template <typename... Ts>
+    friend auto when_all(const TaskFuture<Ts>&... futures);
+
+    template <typename U>
+    friend auto when_all(const std::vector<TaskFuture<U>>& futures);
+
+    template <typename U>
+    friend auto when_any(const std::vector<TaskFuture<U>>& futures);
+
+    std::shared_ptr<Detail::SharedState<T>> state_;
+
+    explicit TaskFuture(std::shared_ptr<Detail::SharedState<T>> state)
+        : state_{std::move(state)}
+    {
+    }
+
+public:
+    TaskFuture() = default;
+
+    bool valid() const
+    {
+        return state_ != nullptr;
+    }
+
+    bool is_ready() const
+    {
+        return state_->is_ready();
+    }
+
+    void wait() const
+    {
+        state_->wait();
+    }
+
+    // blocks until the result is ready and returns a copy of it (or rethrows the task's exception);
+    // meant for code outside the graph - tasks should use then() instead
+    T get() const
+    {
+        state_->wait();
+
+        if (state_->exception())
+            std::rethrow_exception(state_->exception());
+
+        if constexpr (std::is_void<T>::value)
+            return;
+        else
+            return state_->value();
+    }
+
+    // f(const T&) (or f() for void) runs on the pool when this result is ready;
+    // an exception of this task skips f and is passed on to the returned future
+    template <typename F>
+    auto then(F f) const
+    {
+        return Detail::schedule(state_->pool, std::move(f), state_);
+    }
+};
+
+// Runs tasks on a shared ThreadPool. A task declares the tasks it depends on and receives their results
+// (void tasks pass nothing) once all of them are ready:
+//
+//   TaskGraph graph{pool};
+//   auto a = graph.add([] { return 1; });
+//   auto b = graph.add([](int x) { return x + 1; }, a);
+//   auto c = graph.add([](int x) { return x * 2; }, a);
+//   auto d = graph.add([](int x, int y) { return x + y; }, b, c);
+//   d.get(); // 4
+//
+// The destructor waits until every task added to the graph has finished.
+class TaskGraph
+{
+    ThreadPool& pool_;
+
+    std::mutex mtx_;
+    std::condition_variable cv_done_;
+    size_t no_of_pending_ = 0;
+
+    void task_done_()
+    {
+        std::lock_guard<std::mutex> lk{mtx_};
+        if (--no_of_pending_ == 0)
+            cv_done_.notify_all();
+    }
+
+public:
+    explicit TaskGraph(ThreadPool& pool)
+        : pool_{pool}
+    {
+    }
+
+    TaskGraph(const TaskGraph&) = delete;
+    TaskGraph& operator=(const TaskGraph&) = delete;
+
+    ~TaskGraph()
+    {
+        wait();
+    }
+
+    // f(results of dependencies...) runs when all dependencies are ready; a failed dependency
+    // skips f and its exception is passed on to the returned future
+    template <typename F, typename... Ts>
+    auto add(F f, const TaskFuture<Ts>&... dependencies)
+    {
+        {
+            std::lock_guard<std::mutex> lk{mtx_};
+            ++no_of_pending_;
+        }
+
+        auto result = Detail::schedule(pool_, std::move(f), dependencies.state_...);
+        result.state_->on_ready([this] { task_done_(); });
+
+        return result;
+    }
+
+    // blocks until every task added so far has finished
+    void wait()
+    {
+        std::unique_lock<std::mutex> lk{mtx_};
+        cv_done_.wait(lk, [this] { return no_of_pending_ == 0; });
+    }
+};
+
+// ready when all futures are; holds a tuple of their values (void futures contribute nothing)
+// or the first exception in argument order
+template <typename... Ts>
+auto when_all(const TaskFuture<Ts>&... futures)
+{
+    static_assert(sizeof...(Ts) > 0, "when_all needs at least one future");
+
+    ThreadPool& pool = std::get<0>(std::forward_as_tuple(futures...)).state_->pool;
+
+    return Detail::schedule(
+        pool, [](const auto&... values) { return std::make_tuple(values...); }, futures.state_...);
+}
+
+// ready when all futures are; holds their values in order (nothing for void futures)
+// or the first exception in vector order
+template <typename T>
+auto when_all(const std::vector<TaskFuture<T>>& futures)
+{
+    using R = std::conditional_t<std::is_void<T>::value, void, std::vector<Detail::Stored<T>>>;
+
+    if (futures.empty())
+        throw std::invalid_argument("when_all needs at least one future");
+
+    auto result = std::make_shared<Detail::SharedState<R>>(futures.front().state_->pool);
+    auto pending = std::make_shared<std::atomic<size_t>>(futures.size());
+    auto states = std::make_shared<std::vector<std::shared_ptr<Detail::SharedState<T>>>>();
+    for (const auto& f : futures)
+        states->push_back(f.state_);
+
+    for (const auto& state : *states)
+        state->on_ready([result, pending, states] {
+            if (pending->fetch_sub(1) != 1)
+                return;
+
+            for (const auto& s : *states)
+                if (s->exception())
+                {
+                    result->set_exception(s->exception());
+                    return;
+                }
+
+            if constexpr (std::is_void<T>::value)
+                result->set_value(std::monostate{});
+            else
+            {
+                try
+                {
+                    R values;
+                    values.reserve(states->size());
+                    for (const auto& s : *states)
+                        values.push_back(s->value());
+
+                    result->set_value(std::move(values));
+                }
+                catch (...)
+                {
+                    result->set_exception(std::current_exception());
+                }
+            }
+        });
+
+    return TaskFuture<R>{result};
+}
+
+// ready as soon as the first of the futures is; holds its index and value (just the index for void futures)
+// or its exception
+template <typename T>
+auto when_any(const std::vector<TaskFuture<T>>& futures)
+{
+    using R = std::conditional_t<std::is_void<T>::value, size_t, std::pair<size_t, Detail::Stored<T>>>;
+
+    if (futures.empty())
+        throw std::invalid_argument("when_any needs at least one future");
+
+    auto result = std::make_shared<Detail::SharedState<R>>(futures.front().state_->pool);
+    auto is_done = std::make_shared<std::atomic<bool>>(false);
+
+    for (size_t i = 0; i < futures.size(); ++i)
+        futures[i].state_->on_ready([result, is_done, i, state = futures[i].state_] {
+            if (is_done->exchange(true))
+                return;
+
+            if (state->exception())
+                result->set_exception(state->exception());
+            else if constexpr (std::is_void<T>::value)
+                result->set_value(i);
+            else
+            {
+                try
+                {
+                    result->set_value(R{i, state->value()});
+                }
+                catch (...)
+                {
+                    result->set_exception(std::current_exception());
+                }
+            }
+        });
+
+    return TaskFuture<R>{result};
+}
+
+#endif // TASK_GRAPH_HPP
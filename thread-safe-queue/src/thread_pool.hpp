@@ -0,0 +1,84 @@
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+#include <cstddef>
+#include <future>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "task.hpp"
+#include "thread_safe_queue.hpp"
+
+// Fixed-size pool of worker threads pulling tasks from a shared ThreadSafeQueue.
+// The destructor closes the queue, lets the workers drain the remaining tasks and joins them.
+class ThreadPool
+{
+    ThreadSafeQueue<Task> tasks_;
+    std::vector<std::thread> threads_;
+
+    void run()
+    {
+        Task task;
+        while (tasks_.pop(task))
+            task();
+    }
+
+    void shutdown()
+    {
+        tasks_.close();
+
+        for (auto& thd : threads_)
+            thd.join();
+    }
+
+public:
+    explicit ThreadPool(size_t size = std::thread::hardware_concurrency())
+    {
+        if (size == 0)
+            size = 1;
+
+        threads_.reserve(size);
+
+        try
+        {
+            for (size_t i = 0; i < size; ++i)
+                threads_.emplace_back([this] { run(); });
+        }
+        catch (...)
+        {
+            shutdown();
+            throw;
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    ~ThreadPool()
+    {
+        shutdown();
+    }
+
+    size_t size() const
+    {
+        return threads_.size();
+    }
+
+    template <typename F, typename... Args>
+    std::future<TaskResult<F, Args...>> submit(F&& f, Args&&... args)
+    {
+        auto task = make_task(std::forward<F>(f), std::forward<Args>(args)...);
+        tasks_.push(std::move(task.first));
+
+        return std::move(task.second);
+    }
+
+    // fire-and-forget: the task must not throw (it would terminate the worker thread)
+    void post(Task task)
+    {
+        tasks_.push(std::move(task));
+    }
+};
+
+#endif // THREAD_POOL_HPP
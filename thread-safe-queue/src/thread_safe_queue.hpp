@@ -1,89 +1,314 @@
 #ifndef THREAD_SAFE_QUEUE_HPP
 #define THREAD_SAFE_QUEUE_HPP
 
-#include <condition_variable>
+#include <chrono>
+#include <cstddef>
 #include <mutex>
+#include <optional>
 #include <queue>
+#include <stdexcept>
+#include <utility>
 
-template <typename T>
+#include "queue_stats.hpp"
+#include "queue_status.hpp"
+#include "wait_policies.hpp"
+
+// StatsPolicy = QueueStats records lock waits, latencies, queue depth and wake-ups (see stats());
+// the default NoQueueStats compiles all of that away.
+// WaitPolicy decides how consumers wait: CvWait blocks on a condition variable,
+// SpinThenParkWait spins first (see wait_policies.hpp).
+template <typename T, typename StatsPolicy = NoQueueStats, typename WaitPolicy = CvWait>
 class ThreadSafeQueue
 {
     std::queue<T> q_;
     mutable std::mutex q_mtx_;
-    std::condition_variable cv_not_empty_;
+    WaitPolicy not_empty_;
+    bool is_closed_ = false;
+    mutable StatsPolicy stats_;
+
+    std::unique_lock<std::mutex> lock_() const
+    {
+        const auto start = stats_.now();
+        std::unique_lock<std::mutex> lk{q_mtx_};
+        stats_.lock_acquired(start);
+        return lk;
+    }
+
+    std::unique_lock<std::mutex> try_lock_() const
+    {
+        std::unique_lock<std::mutex> lk{q_mtx_, std::try_to_lock};
+        if (!lk)
+            stats_.try_lock_failed();
+        return lk;
+    }
+
+    // wait predicate; every evaluation after the first one follows a wake-up
+    auto has_item_or_closed_()
+    {
+        return [this, woken = false]() mutable {
+            const bool result = !q_.empty() || is_closed_;
+            if (woken)
+                stats_.woken(result);
+            woken = true;
+            return result;
+        };
+    }
+
+    void throw_if_closed_() const
+    {
+        if (is_closed_)
+            throw std::logic_error("push to closed ThreadSafeQueue");
+    }
+
+    template <typename... Args>
+    void push_back_(Args&&... args)
+    {
+        q_.emplace(std::forward<Args>(args)...);
+        stats_.enqueued(q_.size());
+    }
+
+    void pop_front_(T& item)
+    {
+        item = std::move(q_.front());
+        q_.pop();
+        stats_.dequeued();
+    }
+
+    std::optional<T> pop_front_()
+    {
+        std::optional<T> item{std::move(q_.front())};
+        q_.pop();
+        stats_.dequeued();
+        return item;
+    }
+
+    // 0 is what pop_bulk returns for a closed and drained queue - a request for no items would look like shutdown
+    static void throw_if_no_room_(size_t max_n)
+    {
+        if (max_n == 0)
+            throw std::invalid_argument("bulk pop needs max_n > 0");
+    }
+
+    template <typename OutputIt>
+    size_t pop_bulk_(OutputIt& out, size_t max_n)
+    {
+        size_t count = 0;
+        for (; count < max_n && !q_.empty(); ++count)
+        {
+            *out++ = std::move(q_.front());
+            q_.pop();
+            stats_.dequeued();
+        }
+
+        return count;
+    }
 
 public:
     bool empty() const
     {
-        std::lock_guard<std::mutex> lk{q_mtx_};
+        auto lk = lock_();
         return q_.empty();
     }
 
-    void push(const T& item)
+    // wakes all waiting consumers; items already queued can still be popped,
+    // then pops return false/QueueStatus::closed and pushes throw
+    void close()
     {
         {
-            std::lock_guard<std::mutex> lk{q_mtx_};
-            q_.push(item);
+            auto lk = lock_();
+            is_closed_ = true;
         }
 
-        cv_not_empty_.notify_one();
+        not_empty_.notify_all();
+    }
+
+    // true when the queue is closed and drained
+    bool done() const
+    {
+        auto lk = lock_();
+        return is_closed_ && q_.empty();
+    }
+
+    void push(const T& item)
+    {
+        emplace(item);
     }
 
     void push(T&& item)
+    {
+        emplace(std::move(item));
+    }
+
+    // constructs the item in place from args
+    template <typename... Args>
+    void emplace(Args&&... args)
     {
         {
-            std::lock_guard<std::mutex> lk{q_mtx_};
-            q_.push(std::move(item));
+            auto lk = lock_();
+            throw_if_closed_();
+            push_back_(std::forward<Args>(args)...);
         }
 
-        cv_not_empty_.notify_one();
+        not_empty_.notify_one();
     }
 
     void push(std::initializer_list<T> il)
     {
         {
-            std::lock_guard<std::mutex> lk{q_mtx_};
+            auto lk = lock_();
+            throw_if_closed_();
             for (const auto& item : il)
-                q_.push(item);
+                push_back_(item);
+        }
+
+        not_empty_.notify_all();
+    }
+
+    // pushes [first, last) under one lock; pass std::move_iterator-s to move the items
+    template <typename InputIt>
+    void push_range(InputIt first, InputIt last)
+    {
+        if (first == last)
+            return;
+
+        {
+            auto lk = lock_();
+            throw_if_closed_();
+            for (; first != last; ++first)
+                push_back_(*first);
         }
 
-        cv_not_empty_.notify_all();
+        not_empty_.notify_all();
     }
 
     bool try_push(const T& item)
     {
         {
-            std::unique_lock<std::mutex> lk(q_mtx_, std::try_to_lock);
-            if (!lk)
+            auto lk = try_lock_();
+            if (!lk || is_closed_)
                 return false;
 
-            q_.push(item);
+            push_back_(item);
         }
 
-        cv_not_empty_.notify_one();
+        not_empty_.notify_one();
+
+        return true;
+    }
+
+    // item is moved from only when the push succeeds
+    bool try_push(T&& item)
+    {
+        {
+            auto lk = try_lock_();
+            if (!lk || is_closed_)
+                return false;
+
+            push_back_(std::move(item));
+        }
+
+        not_empty_.notify_one();
 
         return true;
     }
 
     bool try_pop(T& item)
     {
-        std::unique_lock<std::mutex> lk{q_mtx_, std::try_to_lock};
+        auto lk = try_lock_();
         if (!lk || q_.empty())
             return false;
 
-        item = std::move(q_.front());
-        q_.pop();
+        pop_front_(item);
         return true;
     }
 
-    void pop(T& item)
+    std::optional<T> try_pop()
     {
-        std::unique_lock<std::mutex> lk{q_mtx_};
+        auto lk = try_lock_();
+        if (!lk || q_.empty())
+            return std::nullopt;
 
-        cv_not_empty_.wait(lk, [&] { return !q_.empty(); });
+        return pop_front_();
+    }
 
-        item = std::move(q_.front());
-        q_.pop();
+    // returns false when the queue has been closed and drained
+    bool pop(T& item)
+    {
+        auto lk = lock_();
+
+        not_empty_.wait(lk, has_item_or_closed_());
+
+        if (q_.empty())
+            return false;
+
+        pop_front_(item);
+        return true;
+    }
+
+    // moves the item out without default-constructing T; empty when the queue has been closed and drained
+    std::optional<T> pop()
+    {
+        auto lk = lock_();
+
+        not_empty_.wait(lk, has_item_or_closed_());
+
+        if (q_.empty())
+            return std::nullopt;
+
+        return pop_front_();
+    }
+
+    template <typename Clock, typename Duration>
+    QueueStatus pop_until(T& item, const std::chrono::time_point<Clock, Duration>& deadline)
+    {
+        auto lk = lock_();
+
+        if (!not_empty_.wait_until(lk, deadline, has_item_or_closed_()))
+            return QueueStatus::timeout;
+
+        if (q_.empty())
+            return QueueStatus::closed;
+
+        pop_front_(item);
+        return QueueStatus::success;
+    }
+
+    template <typename Rep, typename Period>
+    QueueStatus pop_for(T& item, const std::chrono::duration<Rep, Period>& timeout)
+    {
+        return pop_until(item, std::chrono::steady_clock::now() + timeout);
+    }
+
+    // non-blocking; moves up to max_n items to out and returns their number
+    template <typename OutputIt>
+    size_t try_pop_bulk(OutputIt out, size_t max_n)
+    {
+        throw_if_no_room_(max_n);
+
+        auto lk = try_lock_();
+        if (!lk)
+            return 0;
+
+        return pop_bulk_(out, max_n);
+    }
+
+    // waits for at least one item, then moves up to max_n items to out and returns their number;
+    // returns 0 when the queue has been closed and drained
+    template <typename OutputIt>
+    size_t pop_bulk(OutputIt out, size_t max_n)
+    {
+        throw_if_no_room_(max_n);
+
+        auto lk = lock_();
+
+        not_empty_.wait(lk, has_item_or_closed_());
+
+        return pop_bulk_(out, max_n);
+    }
+
+    const StatsPolicy& stats() const
+    {
+        return stats_;
     }
 };
 
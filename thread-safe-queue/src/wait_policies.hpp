@@ -0,0 +1,171 @@
+#ifndef WAIT_POLICIES_HPP
+#define WAIT_POLICIES_HPP
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+// Wait policies decide how ThreadSafeQueue consumers wait for items. Both count their waiters,
+// so a push that finds nobody waiting only does an atomic load instead of notifying.
+// wait/wait_until are called with the queue lock held; notify_one/notify_all after it was released.
+
+// Consumers block on a condition variable (the default).
+class CvWait
+{
+    std::condition_variable cv_;
+    std::atomic<int> waiting_{0}; // changed under the queue lock
+
+public:
+    template <typename Predicate>
+    void wait(std::unique_lock<std::mutex>& lk, Predicate pred)
+    {
+        while (!pred())
+        {
+            waiting_.fetch_add(1, std::memory_order_relaxed);
+            cv_.wait(lk);
+            waiting_.fetch_sub(1, std::memory_order_relaxed);
+        }
+    }
+
+    // returns pred() - false only on timeout
+    template <typename Clock, typename Duration, typename Predicate>
+    bool wait_until(std::unique_lock<std::mutex>& lk, const std::chrono::time_point<Clock, Duration>& deadline, Predicate pred)
+    {
+        while (!pred())
+        {
+            waiting_.fetch_add(1, std::memory_order_relaxed);
+            const auto status = cv_.wait_until(lk, deadline);
+            waiting_.fetch_sub(1, std::memory_order_relaxed);
+
+            if (status == std::cv_status::timeout)
+                return pred();
+        }
+
+        return true;
+    }
+
+    void notify_one()
+    {
+        if (waiting_.load(std::memory_order_relaxed) > 0)
+            cv_.notify_one();
+    }
+
+    void notify_all()
+    {
+        if (waiting_.load(std::memory_order_relaxed) > 0)
+            cv_.notify_all();
+    }
+};
+
+// Consumers release the queue lock and spin (yielding) on an atomic epoch that every notification
+// bumps; only when nothing arrives within spin_count rounds they park on a condition variable.
+// Suits queues where items usually arrive within microseconds, at the cost of burning CPU while spinning.
+class SpinThenParkWait
+{
+    static constexpr int spin_count = 64;
+
+    std::atomic<unsigned> epoch_{0};
+    std::atomic<int> waiting_{0};
+    std::atomic<int> parked_{0};
+    std::mutex park_mtx_;
+    std::condition_variable cv_;
+
+    bool spin_(unsigned epoch)
+    {
+        for (int i = 0; i < spin_count; ++i)
+        {
+            if (epoch_.load(std::memory_order_acquire) != epoch)
+                return true;
+            std::this_thread::yield();
+        }
+
+        return false;
+    }
+
+    template <typename Clock, typename Duration>
+    bool wait_for_notification_(unsigned epoch, const std::chrono::time_point<Clock, Duration>* deadline)
+    {
+        if (spin_(epoch))
+            return true;
+
+        std::unique_lock<std::mutex> lk{park_mtx_};
+        parked_.fetch_add(1, std::memory_order_seq_cst);
+        auto notified = [&] { return epoch_.load(std::memory_order_seq_cst) != epoch; };
+
+        bool result = true;
+        if (deadline)
+            result = cv_.wait_until(lk, *deadline, notified);
+        else
+            cv_.wait(lk, notified);
+
+        parked_.fetch_sub(1, std::memory_order_relaxed);
+
+        return result;
+    }
+
+    template <typename Clock, typename Duration, typename Predicate>
+    bool wait_(std::unique_lock<std::mutex>& lk, const std::chrono::time_point<Clock, Duration>* deadline, Predicate& pred)
+    {
+        while (!pred())
+        {
+            const unsigned epoch = epoch_.load(std::memory_order_relaxed);
+            waiting_.fetch_add(1, std::memory_order_seq_cst);
+            lk.unlock();
+
+            const bool notified = wait_for_notification_(epoch, deadline);
+
+            waiting_.fetch_sub(1, std::memory_order_relaxed);
+            lk.lock();
+
+            if (!notified)
+                return pred();
+        }
+
+        return true;
+    }
+
+    void notify_(bool all)
+    {
+        if (waiting_.load(std::memory_order_seq_cst) == 0)
+            return;
+
+        epoch_.fetch_add(1, std::memory_order_seq_cst);
+
+        if (parked_.load(std::memory_order_seq_cst) > 0)
+        {
+            std::lock_guard<std::mutex> lk{park_mtx_};
+            if (all)
+                cv_.notify_all();
+            else
+                cv_.notify_one();
+        }
+    }
+
+public:
+    template <typename Predicate>
+    void wait(std::unique_lock<std::mutex>& lk, Predicate pred)
+    {
+        wait_(lk, static_cast<const std::chrono::steady_clock::time_point*>(nullptr), pred);
+    }
+
+    // returns pred() - false only on timeout
+    template <typename Clock, typename Duration, typename Predicate>
+    bool wait_until(std::unique_lock<std::mutex>& lk, const std::chrono::time_point<Clock, Duration>& deadline, Predicate pred)
+    {
+        return wait_(lk, &deadline, pred);
+    }
+
+    void notify_one()
+    {
+        notify_(false);
+    }
+
+    void notify_all()
+    {
+        notify_(true);
+    }
+};
+
+#endif // WAIT_POLICIES_HPP
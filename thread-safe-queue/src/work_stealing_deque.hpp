@@ -0,0 +1,151 @@
+#ifndef WORK_STEALING_DEQUE_HPP
+#define WORK_STEALING_DEQUE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "concurrency_utils.hpp"
+
+// Chase-Lev work-stealing deque (Le, Pop, Cohen, Zappa Nardelli - "Correct and Efficient Work-Stealing for Weak Memory Models").
+// The owner thread calls push/pop at the bottom (LIFO); any other thread may steal from the top (FIFO).
+// T must be trivially copyable (typically a pointer). The ring grows on demand; retired rings are
+// kept until the deque is destroyed, because a thief may still be reading from them.
+template <typename T>
+class WorkStealingDeque
+{
+    static_assert(std::is_trivially_copyable<T>::value, "WorkStealingDeque requires trivially copyable items");
+
+    static constexpr size_t cache_line_size = 64;
+
+    class Ring
+    {
+        const int64_t mask_;
+        std::unique_ptr<std::atomic<T>[]> items_;
+
+    public:
+        explicit Ring(int64_t capacity)
+            : mask_(capacity - 1)
+            , items_(new std::atomic<T>[capacity])
+        {
+        }
+
+        int64_t capacity() const
+        {
+            return mask_ + 1;
+        }
+
+        T get(int64_t index) const
+        {
+            return items_[index & mask_].load(std::memory_order_relaxed);
+        }
+
+        void put(int64_t index, T item)
+        {
+            items_[index & mask_].store(item, std::memory_order_relaxed);
+        }
+
+        std::unique_ptr<Ring> grow(int64_t top, int64_t bottom) const
+        {
+            auto ring = std::make_unique<Ring>(2 * capacity());
+            for (int64_t i = top; i < bottom; ++i)
+                ring->put(i, get(i));
+            return ring;
+        }
+    };
+
+    alignas(cache_line_size) std::atomic<int64_t> top_{0};
+    alignas(cache_line_size) std::atomic<int64_t> bottom_{0};
+    std::atomic<Ring*> ring_;
+    std::vector<std::unique_ptr<Ring>> rings_; // owner only
+
+public:
+    explicit WorkStealingDeque(size_t initial_capacity = 1024)
+    {
+        rings_.push_back(std::make_unique<Ring>(static_cast<int64_t>(round_up_to_power_of_2(initial_capacity))));
+        ring_.store(rings_.back().get(), std::memory_order_relaxed);
+    }
+
+    WorkStealingDeque(const WorkStealingDeque&) = delete;
+    WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+
+    // approximate when called concurrently with push/pop/steal
+    bool empty() const
+    {
+        const int64_t b = bottom_.load(std::memory_order_relaxed);
+        const int64_t t = top_.load(std::memory_order_relaxed);
+        return b <= t;
+    }
+
+    // owner only
+    void push(T item)
+    {
+        const int64_t b = bottom_.load(std::memory_order_relaxed);
+        const int64_t t = top_.load(std::memory_order_acquire);
+        Ring* ring = ring_.load(std::memory_order_relaxed);
+
+        if (b - t > ring->capacity() - 1)
+        {
+            rings_.push_back(ring->grow(t, b));
+            ring = rings_.back().get();
+            ring_.store(ring, std::memory_order_release);
+        }
+
+        ring->put(b, item);
+        bottom_.store(b + 1, std::memory_order_release);
+    }
+
+    // owner only; takes the most recently pushed item
+    bool pop(T& item)
+    {
+        const int64_t b = bottom_.load(std::memory_order_relaxed) - 1;
+        Ring* ring = ring_.load(std::memory_order_relaxed);
+        bottom_.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t t = top_.load(std::memory_order_relaxed);
+
+        if (t > b) // empty
+        {
+            bottom_.store(b + 1, std::memory_order_relaxed);
+            return false;
+        }
+
+        item = ring->get(b);
+
+        if (t == b) // last item - race against thieves
+        {
+            const bool won = top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+            bottom_.store(b + 1, std::memory_order_relaxed);
+            return won;
+        }
+
+        return true;
+    }
+
+    // any thread; takes the least recently pushed item.
+    // Returns false when the deque is empty or another thread won the race for the item.
+    bool steal(T& item)
+    {
+        int64_t t = top_.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const int64_t b = bottom_.load(std::memory_order_acquire);
+
+        if (t >= b)
+            return false;
+
+        Ring* ring = ring_.load(std::memory_order_acquire);
+        T stolen = ring->get(t);
+
+        if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+            return false;
+
+        item = stolen;
+        return true;
+    }
+};
+
+#endif // WORK_STEALING_DEQUE_HPP
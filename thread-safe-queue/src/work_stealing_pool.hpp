@@ -0,0 +1,249 @@
+#ifndef WORK_STEALING_POOL_HPP
+#define WORK_STEALING_POOL_HPP
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "task.hpp"
+#include "thread_safe_queue.hpp"
+#include "work_stealing_deque.hpp"
+
+// Thread pool where every worker owns a Chase-Lev deque.
+// Tasks submitted from a worker go to its own deque (popped LIFO); idle workers steal from
+// the other deques (FIFO). Tasks submitted from outside the pool go to a shared ThreadSafeQueue.
+// A task that waits for subtasks should call wait(future), which runs pending tasks meanwhile.
+class WorkStealingPool
+{
+    static constexpr int spin_count = 64;
+
+    ThreadSafeQueue<Task> injection_queue_;
+    std::vector<std::unique_ptr<WorkStealingDeque<Task*>>> deques_;
+    std::vector<std::thread> threads_;
+
+    std::atomic<size_t> pending_{0};
+    std::atomic<bool> done_{false};
+
+    std::atomic<int> sleeping_{0};
+    std::mutex park_mtx_;
+    std::condition_variable cv_work_;
+
+    struct LocalWorker
+    {
+        WorkStealingPool* pool = nullptr;
+        size_t index = 0;
+    };
+
+    static LocalWorker& local_worker()
+    {
+        static thread_local LocalWorker worker;
+        return worker;
+    }
+
+    bool is_local_worker() const
+    {
+        return local_worker().pool == this;
+    }
+
+    bool pop_local(Task& task)
+    {
+        if (!is_local_worker())
+            return false;
+
+        Task* item;
+        if (!deques_[local_worker().index]->pop(item))
+            return false;
+
+        task = std::move(*item);
+        delete item;
+        return true;
+    }
+
+    bool steal(Task& task)
+    {
+        const size_t count = deques_.size();
+        const size_t self = is_local_worker() ? local_worker().index : count;
+        const size_t start = self < count ? self + 1 : 0;
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            const size_t victim = (start + i) % count;
+            if (victim == self)
+                continue;
+
+            Task* item;
+            if (deques_[victim]->steal(item))
+            {
+                task = std::move(*item);
+                delete item;
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    bool has_visible_work() const
+    {
+        if (!injection_queue_.empty())
+            return true;
+
+        for (const auto& deque : deques_)
+            if (!deque->empty())
+                return true;
+
+        return false;
+    }
+
+    // called after the task has been pushed
+    void wake_one()
+    {
+        std::atomic_thread_fence(std::memory_order_seq_cst); // pairs with the fence in park()
+        if (sleeping_.load(std::memory_order_relaxed) > 0)
+        {
+            std::lock_guard<std::mutex> lk{park_mtx_};
+            cv_work_.notify_one();
+        }
+    }
+
+    // either the parking worker sees the pushed task or wake_one() sees the worker sleeping
+    void park()
+    {
+        std::unique_lock<std::mutex> lk{park_mtx_};
+        sleeping_.fetch_add(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst); // pairs with the fence in wake_one()
+        cv_work_.wait(lk, [this] { return done_ || has_visible_work(); });
+        sleeping_.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    void run(size_t index)
+    {
+        local_worker() = LocalWorker{this, index};
+
+        while (!done_)
+        {
+            int idle_rounds = 0;
+            while (!run_pending_task() && !done_)
+            {
+                if (++idle_rounds < spin_count)
+                    std::this_thread::yield();
+                else
+                {
+                    park();
+                    idle_rounds = 0;
+                }
+            }
+        }
+
+        local_worker() = LocalWorker{};
+    }
+
+    void shutdown()
+    {
+        done_ = true;
+        {
+            std::lock_guard<std::mutex> lk{park_mtx_};
+            cv_work_.notify_all();
+        }
+
+        for (auto& thd : threads_)
+            thd.join();
+    }
+
+public:
+    explicit WorkStealingPool(size_t size = std::thread::hardware_concurrency())
+    {
+        if (size == 0)
+            size = 1;
+
+        deques_.reserve(size);
+        for (size_t i = 0; i < size; ++i)
+            deques_.push_back(std::make_unique<WorkStealingDeque<Task*>>());
+
+        threads_.reserve(size);
+
+        try
+        {
+            for (size_t i = 0; i < size; ++i)
+                threads_.emplace_back([this, i] { run(i); });
+        }
+        catch (...)
+        {
+            shutdown();
+            throw;
+        }
+    }
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    // runs all submitted tasks (helping the workers) before joining them
+    ~WorkStealingPool()
+    {
+        while (pending_ > 0)
+        {
+            if (!run_pending_task())
+                std::this_thread::yield();
+        }
+
+        shutdown();
+    }
+
+    size_t size() const
+    {
+        return threads_.size();
+    }
+
+    template <typename F, typename... Args>
+    std::future<TaskResult<F, Args...>> submit(F&& f, Args&&... args)
+    {
+        auto task = make_task(std::forward<F>(f), std::forward<Args>(args)...);
+        ++pending_;
+
+        if (is_local_worker())
+            deques_[local_worker().index]->push(new Task{std::move(task.first)});
+        else
+            injection_queue_.push(std::move(task.first));
+
+        wake_one();
+
+        return std::move(task.second);
+    }
+
+    // runs one task from the local deque, the injection queue or another worker's deque;
+    // returns false when no task was found
+    bool run_pending_task()
+    {
+        Task task;
+
+        if (pop_local(task) || injection_queue_.try_pop(task) || steal(task))
+        {
+            task();
+            --pending_;
+            return true;
+        }
+
+        return false;
+    }
+
+    // runs pending tasks until the future is ready, so a task can wait for its subtasks
+    // without blocking a worker
+    template <typename R>
+    void wait(const std::future<R>& f)
+    {
+        while (f.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+        {
+            if (!run_pending_task())
+                std::this_thread::yield();
+        }
+    }
+};
+
+#endif // WORK_STEALING_POOL_HPP
@@ -0,0 +1,163 @@
+#include <chrono>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include "bounded_thread_safe_queue.hpp"
+#include "catch.hpp"
+
+using namespace std;
+
+TEST_CASE("BoundedThreadSafeQueue")
+{
+    BoundedThreadSafeQueue<int> bq{3};
+
+    SECTION("is empty after creation")
+    {
+        REQUIRE(bq.empty() == true);
+        REQUIRE(bq.capacity() == 3);
+    }
+
+    SECTION("is full when size reaches capacity")
+    {
+        bq.push(1);
+        bq.push(2);
+        bq.push(3);
+
+        REQUIRE(bq.full() == true);
+        REQUIRE(bq.size() == 3);
+    }
+
+    SECTION("try_push fails when full")
+    {
+        bq.push(1);
+        bq.push(2);
+        bq.push(3);
+
+        REQUIRE(bq.try_push(4) == false);
+    }
+
+    SECTION("pops items in FIFO order after wrap around")
+    {
+        int item;
+
+        for (int i = 0; i < 10; ++i)
+        {
+            REQUIRE(bq.try_push(i));
+            REQUIRE(bq.try_pop(item));
+            REQUIRE(item == i);
+        }
+
+        REQUIRE(bq.empty() == true);
+    }
+
+    SECTION("push_for times out when full")
+    {
+        bq.push(1);
+        bq.push(2);
+        bq.push(3);
+
+        auto result = bq.push_for(4, 50ms);
+
+        REQUIRE(result == false);
+        REQUIRE(bq.size() == 3);
+    }
+
+    SECTION("pop_for times out when empty")
+    {
+        int item = 0;
+        auto result = bq.pop_for(item, 50ms);
+
+        REQUIRE(result == QueueStatus::timeout);
+    }
+
+    SECTION("pop_for tells a closed queue from a timeout")
+    {
+        bq.push(1);
+        bq.close();
+
+        int item = 0;
+        REQUIRE(bq.pop_for(item, 50ms) == QueueStatus::success);
+        REQUIRE(item == 1);
+        REQUIRE(bq.pop_for(item, 50ms) == QueueStatus::closed);
+        REQUIRE(bq.pop_until(item, chrono::steady_clock::now() + 50ms) == QueueStatus::closed);
+    }
+
+    SECTION("producer waits when pushing to full queue")
+    {
+        bq.push(1);
+        bq.push(2);
+        bq.push(3);
+
+        chrono::steady_clock::time_point t1;
+
+        thread thd{[&bq, &t1] {
+            bq.push(4);
+            t1 = chrono::steady_clock::now();
+        }};
+
+        this_thread::sleep_for(200ms);
+        chrono::steady_clock::time_point t2 = chrono::steady_clock::now();
+        int item;
+        bq.pop(item);
+        thd.join();
+
+        REQUIRE(t1 >= t2);
+        REQUIRE(item == 1);
+        REQUIRE(bq.size() == 3);
+    }
+
+    SECTION("items pushed before close can be drained")
+    {
+        bq.push(1);
+        bq.close();
+
+        int item;
+        REQUIRE(bq.done() == false);
+        REQUIRE(bq.pop(item) == true);
+        REQUIRE(bq.pop(item) == false);
+        REQUIRE(bq.done() == true);
+        REQUIRE_THROWS_AS(bq.push(2), logic_error);
+        REQUIRE(bq.try_push(2) == false);
+    }
+
+    SECTION("close wakes producer blocked on full queue")
+    {
+        bq.push(1);
+        bq.push(2);
+        bq.push(3);
+
+        bool thrown = false;
+
+        thread thd{[&bq, &thrown] {
+            try
+            {
+                bq.push(4);
+            }
+            catch (const logic_error&)
+            {
+                thrown = true;
+            }
+        }};
+
+        this_thread::sleep_for(100ms);
+        bq.close();
+        thd.join();
+
+        REQUIRE(thrown);
+    }
+}
+
+TEST_CASE("BoundedThreadSafeQueue with move-only items")
+{
+    BoundedThreadSafeQueue<unique_ptr<string>> bq{2};
+
+    bq.push(make_unique<string>("one"));
+    bq.push(make_unique<string>("two"));
+
+    unique_ptr<string> item;
+    bq.pop(item);
+
+    REQUIRE(*item == "one");
+}
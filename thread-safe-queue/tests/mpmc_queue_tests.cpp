@@ -0,0 +1,120 @@
+#include <atomic>
+#include <memory>
+#include <numeric>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "catch.hpp"
+#include "mpmc_queue.hpp"
+#include "thread_safe_queue.hpp"
+
+using namespace std;
+
+TEST_CASE("MpmcQueue")
+{
+    MpmcQueue<int> q{4};
+
+    SECTION("is empty after creation")
+    {
+        REQUIRE(q.empty() == true);
+        REQUIRE(q.capacity() == 4);
+    }
+
+    SECTION("try_push fails when full")
+    {
+        for (int i = 0; i < 4; ++i)
+            REQUIRE(q.try_push(i));
+
+        REQUIRE(q.try_push(4) == false);
+    }
+
+    SECTION("pops items in FIFO order")
+    {
+        q.push(1);
+        q.push(2);
+
+        int item;
+        REQUIRE(q.try_pop(item));
+        REQUIRE(item == 1);
+        REQUIRE(q.try_pop(item));
+        REQUIRE(item == 2);
+        REQUIRE(q.try_pop(item) == false);
+        REQUIRE(q.empty() == true);
+    }
+
+    SECTION("blocked consumer is woken by push")
+    {
+        int item = 0;
+
+        thread consumer{[&q, &item] { q.pop(item); }};
+
+        this_thread::sleep_for(100ms);
+        q.push(42);
+        consumer.join();
+
+        REQUIRE(item == 42);
+    }
+}
+
+TEST_CASE("MpmcQueue with move-only items")
+{
+    MpmcQueue<unique_ptr<string>> q{2};
+
+    q.push(make_unique<string>("one"));
+    q.push(make_unique<string>("two"));
+
+    unique_ptr<string> item;
+    q.pop(item);
+
+    REQUIRE(*item == "one");
+}
+
+template <typename Queue>
+long sum_through_queue(Queue& q, int no_of_producers, int no_of_consumers, int items_per_producer)
+{
+    atomic<long> sum{0};
+    vector<thread> threads;
+
+    for (int p = 0; p < no_of_producers; ++p)
+        threads.emplace_back([&q, items_per_producer] {
+            for (int i = 1; i <= items_per_producer; ++i)
+                q.push(i);
+        });
+
+    const int total = no_of_producers * items_per_producer;
+    for (int c = 0; c < no_of_consumers; ++c)
+        threads.emplace_back([&q, &sum, c, total, no_of_consumers] {
+            int item{};
+            for (int i = c; i < total; i += no_of_consumers)
+            {
+                q.pop(item);
+                sum += item;
+            }
+        });
+
+    for (auto& thd : threads)
+        thd.join();
+
+    return sum;
+}
+
+TEST_CASE("many producers and consumers transfer all items")
+{
+    const int items_per_producer = 10'000;
+    const long expected = 4L * items_per_producer * (items_per_producer + 1) / 2;
+
+    SECTION("ThreadSafeQueue")
+    {
+        ThreadSafeQueue<int> q;
+
+        REQUIRE(sum_through_queue(q, 4, 4, items_per_producer) == expected);
+    }
+
+    SECTION("MpmcQueue")
+    {
+        MpmcQueue<int> q{64};
+
+        REQUIRE(sum_through_queue(q, 4, 4, items_per_producer) == expected);
+    }
+}
@@ -0,0 +1,76 @@
+#include <atomic>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "catch.hpp"
+#include "pipeline.hpp"
+
+using namespace std;
+
+TEST_CASE("Pipeline")
+{
+    Pipeline pipeline{4};
+    const int no_of_items = 10'000;
+
+    auto numbers = pipeline.source<int>("numbers", [](Emitter<int>& out) {
+        for (int i = 1; i <= no_of_items; ++i)
+            out.push(i);
+    }, 16);
+
+    SECTION("passes all items through transform stages to sink")
+    {
+        auto squares = pipeline.transform(numbers, "squares", 4, [](int x) { return static_cast<long>(x) * x; });
+        auto texts = pipeline.transform(squares, "to_string", 2, [](long x) { return to_string(x); }, 8);
+
+        atomic<long> sum{0};
+        atomic<int> count{0};
+        pipeline.sink(texts, "sum", 2, [&](const string& s) {
+            sum += stol(s);
+            ++count;
+        });
+
+        pipeline.run();
+
+        REQUIRE(count == no_of_items);
+        REQUIRE(sum == static_cast<long>(no_of_items) * (no_of_items + 1) * (2 * no_of_items + 1) / 6);
+
+        auto stats = pipeline.stats();
+        REQUIRE(stats.size() == 4);
+        REQUIRE(stats[0].name == "numbers");
+        REQUIRE(stats[0].items == no_of_items);
+        REQUIRE(stats[1].threads == 4);
+        REQUIRE(stats[3].items == no_of_items);
+        REQUIRE(stats[3].items_per_s > 0.0);
+        REQUIRE(stats[3].queue_depth == 0);
+        REQUIRE(stats[3].queue_high_water <= 4);
+    }
+
+    SECTION("exception thrown in a stage is rethrown from run")
+    {
+        auto checked = pipeline.transform(numbers, "check", 2, [](int x) {
+            if (x == 13)
+                throw runtime_error("Error#13");
+            return x;
+        });
+
+        pipeline.sink(checked, "ignore", 1, [](int) {});
+
+        REQUIRE_THROWS_AS(pipeline.run(), runtime_error);
+    }
+
+    SECTION("a port can be connected to one stage only")
+    {
+        auto doubled = pipeline.transform(numbers, "double", 2, [](int x) { return 2 * x; });
+
+        REQUIRE_THROWS_AS(pipeline.sink(numbers, "again", 1, [](int) {}), logic_error);
+
+        atomic<int> count{0};
+        pipeline.sink(doubled, "count", 1, [&](int) { ++count; });
+        pipeline.run();
+
+        REQUIRE(count == no_of_items);
+        REQUIRE(pipeline.stats().size() == 3);
+    }
+}
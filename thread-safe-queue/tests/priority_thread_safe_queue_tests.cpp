@@ -0,0 +1,164 @@
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "catch.hpp"
+#include "priority_thread_safe_queue.hpp"
+
+using namespace std;
+
+TEST_CASE("PriorityThreadSafeQueue")
+{
+    PriorityThreadSafeQueue<int> q{3};
+
+    SECTION("is empty after creation")
+    {
+        REQUIRE(q.empty() == true);
+        REQUIRE(q.no_of_priorities() == 3);
+    }
+
+    SECTION("pops highest priority first")
+    {
+        q.push(1, 2);
+        q.push(2, 1);
+        q.push(3, 0);
+
+        int item;
+        REQUIRE(q.try_pop(item));
+        REQUIRE(item == 3);
+        REQUIRE(q.try_pop(item));
+        REQUIRE(item == 2);
+        REQUIRE(q.try_pop(item));
+        REQUIRE(item == 1);
+        REQUIRE(q.try_pop(item) == false);
+    }
+
+    SECTION("items of the same priority are FIFO")
+    {
+        q.push(1, 1);
+        q.push(2, 1);
+
+        int item;
+        q.pop(item);
+        REQUIRE(item == 1);
+    }
+
+    SECTION("client waits when poping from empty")
+    {
+        int item = 0;
+
+        thread consumer{[&q, &item] { q.pop(item); }};
+
+        this_thread::sleep_for(100ms);
+        q.push(42, 2);
+        consumer.join();
+
+        REQUIRE(item == 42);
+    }
+
+    SECTION("close wakes waiting consumers and rejects pushes")
+    {
+        q.push(1, 0);
+        bool result = true;
+
+        thread consumer{[&q, &result] {
+            int item;
+            q.pop(item);
+            result = q.pop(item);
+        }};
+
+        this_thread::sleep_for(100ms);
+        q.close();
+        consumer.join();
+
+        REQUIRE(result == false);
+        REQUIRE(q.done() == true);
+        REQUIRE_THROWS_AS(q.push(2, 0), logic_error);
+        REQUIRE(q.try_push(2, 0) == false);
+    }
+
+    SECTION("pop_for times out when empty")
+    {
+        int item = 0;
+        REQUIRE(q.pop_for(item, 50ms) == QueueStatus::timeout);
+    }
+
+    SECTION("pop_for takes the highest priority and tells a closed queue from a timeout")
+    {
+        q.push(1, 2);
+        q.push(2, 0);
+        q.close();
+
+        int item = 0;
+        REQUIRE(q.pop_for(item, 50ms) == QueueStatus::success);
+        REQUIRE(item == 2);
+        REQUIRE(q.pop_until(item, chrono::steady_clock::now() + 50ms) == QueueStatus::success);
+        REQUIRE(item == 1);
+        REQUIRE(q.pop_for(item, 50ms) == QueueStatus::closed);
+    }
+
+    SECTION("pop_for wakes up on push")
+    {
+        thread thd{[&q] {
+            this_thread::sleep_for(50ms);
+            q.push(7, 1);
+        }};
+
+        int item = 0;
+        REQUIRE(q.pop_for(item, 5s) == QueueStatus::success);
+        REQUIRE(item == 7);
+        thd.join();
+    }
+
+    SECTION("rejects priorities out of range")
+    {
+        REQUIRE_THROWS_AS(q.push(1, 3), out_of_range);
+        REQUIRE_THROWS_AS(q.try_push(1, 3), out_of_range);
+        REQUIRE(q.empty() == true);
+    }
+}
+
+TEST_CASE("PriorityThreadSafeQueue with move-only items")
+{
+    PriorityThreadSafeQueue<unique_ptr<int>> q{2};
+
+    q.push(make_unique<int>(1), 1);
+    q.push(make_unique<int>(2), 0);
+
+    unique_ptr<int> item;
+    q.pop(item);
+
+    REQUIRE(*item == 2);
+}
+
+TEST_CASE("PriorityThreadSafeQueue - many producers and consumers transfer all items")
+{
+    PriorityThreadSafeQueue<int> q{4};
+    const int items_per_producer = 10'000;
+    atomic<long> sum{0};
+    vector<thread> threads;
+
+    for (int p = 0; p < 4; ++p)
+        threads.emplace_back([&q, p] {
+            for (int i = 1; i <= items_per_producer; ++i)
+                q.push(i, p);
+        });
+
+    for (int c = 0; c < 4; ++c)
+        threads.emplace_back([&q, &sum] {
+            int item{};
+            for (int i = 0; i < items_per_producer; ++i)
+            {
+                q.pop(item);
+                sum += item;
+            }
+        });
+
+    for (auto& thd : threads)
+        thd.join();
+
+    REQUIRE(sum == 4L * items_per_producer * (items_per_producer + 1) / 2);
+}
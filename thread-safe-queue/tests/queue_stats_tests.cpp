@@ -0,0 +1,91 @@
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "catch.hpp"
+#include "queue_stats.hpp"
+#include "thread_safe_queue.hpp"
+
+using namespace std;
+
+TEST_CASE("DurationHistogram")
+{
+    DurationHistogram h;
+
+    SECTION("samples land in power-of-2 buckets")
+    {
+        REQUIRE(DurationHistogram::bucket_of(0) == 0);
+        REQUIRE(DurationHistogram::bucket_of(1) == 0);
+        REQUIRE(DurationHistogram::bucket_of(2) == 1);
+        REQUIRE(DurationHistogram::bucket_of(1023) == 9);
+        REQUIRE(DurationHistogram::bucket_of(1024) == 10);
+    }
+
+    SECTION("percentile returns upper bound of bucket")
+    {
+        h.buckets[3] = 99;
+        h.buckets[10] = 1;
+
+        REQUIRE(h.count() == 100);
+        REQUIRE(h.percentile(0.5) == 16);
+        REQUIRE(h.percentile(1.0) == 2048);
+    }
+
+    SECTION("percentile of empty histogram is 0")
+    {
+        REQUIRE(h.percentile(0.99) == 0);
+    }
+}
+
+TEST_CASE("ThreadSafeQueue with QueueStats")
+{
+    ThreadSafeQueue<int, QueueStats> q;
+
+    SECTION("tracks high-water mark")
+    {
+        q.push({1, 2, 3});
+        int item;
+        q.pop(item);
+        q.push(4);
+
+        REQUIRE(q.stats().snapshot().high_water_mark == 3);
+    }
+
+    SECTION("records enqueue-to-dequeue latency of every popped item")
+    {
+        q.push(1);
+        q.emplace(2);
+        this_thread::sleep_for(10ms);
+
+        vector<int> items;
+        q.pop_bulk(back_inserter(items), 2);
+
+        const auto stats = q.stats().snapshot();
+        REQUIRE(stats.latency.count() == 2);
+        REQUIRE(stats.latency.percentile(0.5) >= 10'000'000);
+    }
+
+    SECTION("records lock waits")
+    {
+        q.push(1);
+        q.empty();
+
+        REQUIRE(q.stats().snapshot().lock_wait.count() == 2);
+    }
+
+    SECTION("counts wake-ups of waiting consumers")
+    {
+        thread consumer{[&q] {
+            int item;
+            q.pop(item);
+        }};
+
+        this_thread::sleep_for(100ms);
+        q.push(1);
+        consumer.join();
+
+        const auto stats = q.stats().snapshot();
+        REQUIRE(stats.wakeups >= 1);
+        REQUIRE(stats.wakeups - stats.spurious_wakeups == 1);
+    }
+}
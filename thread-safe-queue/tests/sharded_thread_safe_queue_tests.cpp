@@ -0,0 +1,121 @@
+#include <atomic>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "catch.hpp"
+#include "sharded_thread_safe_queue.hpp"
+
+using namespace std;
+
+TEST_CASE("ShardedThreadSafeQueue")
+{
+    ShardedThreadSafeQueue<int> q{4};
+
+    SECTION("is empty after creation")
+    {
+        REQUIRE(q.empty() == true);
+        REQUIRE(q.no_of_lanes() == 4);
+    }
+
+    SECTION("items from one producer are FIFO")
+    {
+        q.push(1);
+        q.push(2);
+
+        int item;
+        REQUIRE(q.try_pop(item));
+        REQUIRE(item == 1);
+        REQUIRE(q.try_pop(item));
+        REQUIRE(item == 2);
+        REQUIRE(q.try_pop(item) == false);
+    }
+
+    SECTION("consumer takes items from other lanes")
+    {
+        thread producer{[&q] { q.push(42); }};
+        producer.join();
+
+        int item;
+        REQUIRE(q.try_pop(item));
+        REQUIRE(item == 42);
+    }
+
+    SECTION("client waits when poping from empty")
+    {
+        int item = 0;
+
+        thread consumer{[&q, &item] { q.pop(item); }};
+
+        this_thread::sleep_for(100ms);
+        q.push(42);
+        consumer.join();
+
+        REQUIRE(item == 42);
+    }
+
+    SECTION("close wakes waiting consumers and rejects pushes")
+    {
+        bool result = true;
+
+        thread consumer{[&q, &result] {
+            int item;
+            result = q.pop(item);
+        }};
+
+        this_thread::sleep_for(100ms);
+        q.close();
+        consumer.join();
+
+        REQUIRE(result == false);
+        REQUIRE(q.done() == true);
+        REQUIRE_THROWS_AS(q.push(1), logic_error);
+        REQUIRE(q.try_push(1) == false);
+    }
+}
+
+TEST_CASE("ShardedThreadSafeQueue with move-only items")
+{
+    ShardedThreadSafeQueue<unique_ptr<int>> q{2};
+
+    q.push(make_unique<int>(1));
+
+    unique_ptr<int> item;
+    q.pop(item);
+
+    REQUIRE(*item == 1);
+}
+
+TEST_CASE("ShardedThreadSafeQueue - preserves per-producer order")
+{
+    const int no_of_producers = 8;
+    const int items_per_producer = 10'000;
+
+    ShardedThreadSafeQueue<pair<int, int>> q{3};
+    vector<thread> producers;
+
+    for (int p = 0; p < no_of_producers; ++p)
+        producers.emplace_back([&q, p] {
+            for (int i = 0; i < items_per_producer; ++i)
+                q.push({p, i});
+        });
+
+    vector<int> last_seen(no_of_producers, -1);
+    bool in_order = true;
+
+    pair<int, int> item;
+    for (int i = 0; i < no_of_producers * items_per_producer; ++i)
+    {
+        q.pop(item);
+        in_order = in_order && item.second == last_seen[item.first] + 1;
+        last_seen[item.first] = item.second;
+    }
+
+    for (auto& thd : producers)
+        thd.join();
+
+    REQUIRE(in_order);
+    REQUIRE(q.empty() == true);
+}
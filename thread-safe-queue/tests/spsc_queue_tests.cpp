@@ -0,0 +1,85 @@
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "catch.hpp"
+#include "spsc_queue.hpp"
+
+using namespace std;
+
+TEST_CASE("SpscQueue")
+{
+    SpscQueue<int> q{4};
+
+    SECTION("is empty after creation")
+    {
+        REQUIRE(q.empty() == true);
+    }
+
+    SECTION("capacity is rounded up to power of 2")
+    {
+        SpscQueue<int> q3{3};
+
+        REQUIRE(q3.capacity() == 4);
+    }
+
+    SECTION("try_push fails when full")
+    {
+        for (int i = 0; i < 4; ++i)
+            REQUIRE(q.try_push(i));
+
+        REQUIRE(q.try_push(4) == false);
+    }
+
+    SECTION("pops items in FIFO order")
+    {
+        q.push(1);
+        q.push(2);
+
+        int item;
+        REQUIRE(q.try_pop(item));
+        REQUIRE(item == 1);
+        REQUIRE(q.try_pop(item));
+        REQUIRE(item == 2);
+        REQUIRE(q.try_pop(item) == false);
+    }
+
+    SECTION("transfers all items from producer to consumer in order")
+    {
+        const int count = 100'000;
+        vector<int> received;
+        received.reserve(count);
+
+        thread consumer{[&q, &received, count] {
+            int item;
+            for (int i = 0; i < count; ++i)
+            {
+                q.pop(item);
+                received.push_back(item);
+            }
+        }};
+
+        for (int i = 0; i < count; ++i)
+            q.push(i);
+
+        consumer.join();
+
+        REQUIRE(received.size() == count);
+        for (int i = 0; i < count; ++i)
+            REQUIRE(received[i] == i);
+    }
+}
+
+TEST_CASE("SpscQueue with move-only items")
+{
+    SpscQueue<unique_ptr<string>> q{2};
+
+    q.push(make_unique<string>("one"));
+    q.push(make_unique<string>("two"));
+
+    unique_ptr<string> item;
+    q.pop(item);
+
+    REQUIRE(*item == "one");
+}
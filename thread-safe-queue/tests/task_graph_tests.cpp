@@ -0,0 +1,231 @@
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#include "catch.hpp"
+#include "task_graph.hpp"
+
+using namespace std;
+
+TEST_CASE("TaskGraph")
+{
+    ThreadPool pool{4};
+    TaskGraph graph{pool};
+
+    SECTION("task without dependencies returns its result")
+    {
+        auto answer = graph.add([] { return 42; });
+
+        REQUIRE(answer.get() == 42);
+    }
+
+    SECTION("tasks receive results of their dependencies")
+    {
+        auto a = graph.add([] { return 1; });
+        auto b = graph.add([](int x) { return x + 1; }, a);
+        auto c = graph.add([](int x) { return x * 10; }, a);
+        auto d = graph.add([](int x, int y) { return to_string(x) + "," + to_string(y); }, b, c);
+
+        REQUIRE(d.get() == "2,10");
+    }
+
+    SECTION("void dependencies only order the tasks")
+    {
+        atomic<int> counter{0};
+
+        auto first = graph.add([&counter] {
+            this_thread::sleep_for(50ms);
+            counter = 1;
+        });
+        auto value = graph.add([] { return 2; });
+        auto second = graph.add([&counter](int x) { return counter.load() + x; }, first, value);
+
+        REQUIRE(second.get() == 3);
+    }
+
+    SECTION("exception propagates along edges and skips dependent tasks")
+    {
+        atomic<bool> has_run{false};
+
+        auto failing = graph.add([]() -> int { throw runtime_error("Error#13"); });
+        auto ok = graph.add([] { return 1; });
+        auto dependent = graph.add([&has_run](int x, int y) { has_run = true; return x + y; }, ok, failing);
+        auto next = dependent.then([&has_run](int x) { has_run = true; return x; });
+
+        REQUIRE_THROWS_AS(next.get(), runtime_error);
+        REQUIRE_THROWS_AS(dependent.get(), runtime_error);
+        REQUIRE(has_run == false);
+    }
+
+    SECTION("wait blocks until all added tasks have finished")
+    {
+        atomic<int> counter{0};
+
+        for (int i = 0; i < 100; ++i)
+            graph.add([&counter] { ++counter; });
+
+        graph.wait();
+
+        REQUIRE(counter == 100);
+    }
+}
+
+TEST_CASE("TaskFuture::then")
+{
+    ThreadPool pool{2};
+    TaskGraph graph{pool};
+
+    SECTION("continuations can be chained")
+    {
+        auto result = graph.add([] { return 2; }).then([](int x) { return x * 3; }).then([](int x) { return to_string(x); });
+
+        REQUIRE(result.get() == "6");
+    }
+
+    SECTION("one result can have many continuations")
+    {
+        auto source = graph.add([] { return 10; });
+
+        vector<TaskFuture<int>> results;
+        for (int i = 0; i < 10; ++i)
+            results.push_back(source.then([i](int x) { return x + i; }));
+
+        for (int i = 0; i < 10; ++i)
+            REQUIRE(results[i].get() == 10 + i);
+    }
+
+    SECTION("continuation of a void task")
+    {
+        auto result = graph.add([] {}).then([] { return 1; });
+
+        REQUIRE(result.get() == 1);
+    }
+}
+
+TEST_CASE("TaskGraph - waiting for dependencies does not block workers")
+{
+    ThreadPool pool{1};
+    TaskGraph graph{pool};
+
+    // with one worker, a task blocking on another task's future would deadlock
+    const int no_of_tasks = 1000;
+
+    vector<TaskFuture<int>> tasks;
+    for (int i = 0; i < no_of_tasks; ++i)
+        tasks.push_back(graph.add([i] { return i; }));
+
+    auto sum = when_all(tasks).then([](const vector<int>& values) {
+        int result = 0;
+        for (int v : values)
+            result += v;
+        return result;
+    });
+
+    auto chain = graph.add([] { return 0; });
+    for (int i = 0; i < no_of_tasks; ++i)
+        chain = chain.then([](int x) { return x + 1; });
+
+    REQUIRE(sum.get() == no_of_tasks * (no_of_tasks - 1) / 2);
+    REQUIRE(chain.get() == no_of_tasks);
+}
+
+TEST_CASE("TaskGraph - dependent task scheduled after the pool has been closed")
+{
+    unique_ptr<TaskGraph> graph;
+    TaskFuture<int> first;
+    TaskFuture<int> second;
+
+    {
+        ThreadPool pool{1};
+        graph = make_unique<TaskGraph>(pool);
+
+        first = graph->add([] {
+            this_thread::sleep_for(100ms); // still running when the pool destructor closes the queue
+            return 1;
+        });
+        second = first.then([](int x) { return x + 1; });
+    }
+
+    REQUIRE(first.get() == 1); // not overwritten by the failure to schedule second
+    REQUIRE_THROWS_AS(second.get(), logic_error);
+
+    graph.reset();
+}
+
+TEST_CASE("TaskGraph - a result can be set only once")
+{
+    ThreadPool pool{1};
+    Detail::SharedState<int> state{pool};
+
+    state.set_value(1);
+
+    REQUIRE_THROWS_AS(state.set_value(2), logic_error);
+    REQUIRE_THROWS_AS(state.set_exception(make_exception_ptr(runtime_error("Error#1"))), logic_error);
+    REQUIRE(state.value() == 1);
+    REQUIRE_FALSE(state.exception());
+}
+
+TEST_CASE("when_all")
+{
+    ThreadPool pool{4};
+    TaskGraph graph{pool};
+
+    SECTION("of different types gives a tuple of values")
+    {
+        auto a = graph.add([] { return 1; });
+        auto b = graph.add([] { return string{"two"}; });
+        auto c = graph.add([] {});
+
+        auto all = when_all(a, b, c);
+
+        REQUIRE(all.get() == make_tuple(1, string{"two"}));
+    }
+
+    SECTION("of a vector gives values in order")
+    {
+        vector<TaskFuture<int>> squares;
+        for (int i = 1; i < 10; ++i)
+            squares.push_back(graph.add([i] {
+                this_thread::sleep_for(chrono::milliseconds(10 - i));
+                return i * i;
+            }));
+
+        auto all = when_all(squares).get();
+
+        for (int i = 1; i < 10; ++i)
+            REQUIRE(all[i - 1] == i * i);
+    }
+
+    SECTION("passes on the first exception")
+    {
+        vector<TaskFuture<int>> tasks;
+        tasks.push_back(graph.add([] { return 1; }));
+        tasks.push_back(graph.add([]() -> int { throw logic_error("Error#1"); }));
+
+        REQUIRE_THROWS_AS(when_all(tasks).get(), logic_error);
+    }
+}
+
+TEST_CASE("when_any")
+{
+    ThreadPool pool{4};
+    TaskGraph graph{pool};
+
+    vector<TaskFuture<int>> tasks;
+    tasks.push_back(graph.add([] {
+        this_thread::sleep_for(200ms);
+        return 1;
+    }));
+    tasks.push_back(graph.add([] { return 2; }));
+
+    auto first = when_any(tasks).get();
+
+    REQUIRE(first.first == 1);
+    REQUIRE(first.second == 2);
+}
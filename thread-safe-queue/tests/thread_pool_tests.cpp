@@ -0,0 +1,82 @@
+#include <atomic>
+#include <future>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "catch.hpp"
+#include "thread_pool.hpp"
+
+using namespace std;
+
+int square(int x)
+{
+    return x * x;
+}
+
+TEST_CASE("ThreadPool")
+{
+    ThreadPool pool{4};
+
+    SECTION("has requested number of workers")
+    {
+        REQUIRE(pool.size() == 4);
+    }
+
+    SECTION("submit returns future with result")
+    {
+        vector<future<int>> results;
+
+        for (int i = 1; i < 10; ++i)
+            results.push_back(pool.submit(square, i));
+
+        for (int i = 1; i < 10; ++i)
+            REQUIRE(results[i - 1].get() == i * i);
+    }
+
+    SECTION("exception is propagated through future")
+    {
+        auto f = pool.submit([] { throw runtime_error("Error#13"); });
+
+        REQUIRE_THROWS_AS(f.get(), runtime_error);
+    }
+
+    SECTION("accepts move-only callables and arguments")
+    {
+        auto text = make_unique<string>("text");
+        auto f = pool.submit([](unique_ptr<string> s, const string& suffix) { return *s + suffix; }, move(text), "!");
+
+        REQUIRE(f.get() == "text!");
+    }
+
+    SECTION("runs many short tasks")
+    {
+        const int no_of_tasks = 100'000;
+        atomic<int> counter{0};
+        vector<future<void>> results;
+        results.reserve(no_of_tasks);
+
+        for (int i = 0; i < no_of_tasks; ++i)
+            results.push_back(pool.submit([&counter] { ++counter; }));
+
+        for (auto& f : results)
+            f.wait();
+
+        REQUIRE(counter == no_of_tasks);
+    }
+}
+
+TEST_CASE("ThreadPool - destructor runs queued tasks")
+{
+    atomic<int> counter{0};
+
+    {
+        ThreadPool pool{2};
+
+        for (int i = 0; i < 1000; ++i)
+            pool.submit([&counter] { ++counter; });
+    }
+
+    REQUIRE(counter == 1000);
+}
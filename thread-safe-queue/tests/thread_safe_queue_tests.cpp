@@ -1,7 +1,14 @@
+#include <algorithm>
 #include <chrono>
 #include <condition_variable>
+#include <iterator>
+#include <memory>
+#include <optional>
 #include <queue>
+#include <stdexcept>
+#include <string>
 #include <thread>
+#include <vector>
 
 #include "catch.hpp"
 #include "thread_safe_queue.hpp"
@@ -87,3 +94,202 @@ TEST_CASE("ThreadSafeQueue")
         REQUIRE(none_of(items.begin(), items.end(), [](int x) { return x == 0; }));
     }
 }
+
+TEST_CASE("ThreadSafeQueue - batch operations")
+{
+    ThreadSafeQueue<int> tsq;
+
+    SECTION("push_range pushes all items in order")
+    {
+        vector<int> items = {1, 2, 3, 4};
+        tsq.push_range(items.begin(), items.end());
+
+        vector<int> popped;
+        auto count = tsq.try_pop_bulk(back_inserter(popped), 10);
+
+        REQUIRE(count == 4);
+        REQUIRE(popped == items);
+        REQUIRE(tsq.empty() == true);
+    }
+
+    SECTION("push_range moves items from move iterators")
+    {
+        ThreadSafeQueue<unique_ptr<int>> q;
+        vector<unique_ptr<int>> items;
+        items.push_back(make_unique<int>(1));
+        items.push_back(make_unique<int>(2));
+
+        q.push_range(make_move_iterator(items.begin()), make_move_iterator(items.end()));
+
+        unique_ptr<int> item;
+        q.pop(item);
+        REQUIRE(*item == 1);
+        REQUIRE(items[0] == nullptr);
+    }
+
+    SECTION("pop_bulk drains at most max_n items")
+    {
+        tsq.push({1, 2, 3, 4, 5});
+
+        vector<int> popped(3);
+        auto count = tsq.pop_bulk(popped.begin(), 3);
+
+        REQUIRE(count == 3);
+        REQUIRE(popped == vector<int>{1, 2, 3});
+        REQUIRE(tsq.empty() == false);
+    }
+
+    SECTION("bulk pops reject max_n == 0 instead of waiting")
+    {
+        vector<int> popped;
+
+        REQUIRE_THROWS_AS(tsq.pop_bulk(back_inserter(popped), 0), invalid_argument);
+        REQUIRE_THROWS_AS(tsq.try_pop_bulk(back_inserter(popped), 0), invalid_argument);
+    }
+
+    SECTION("try_pop_bulk returns 0 when empty")
+    {
+        vector<int> popped;
+
+        REQUIRE(tsq.try_pop_bulk(back_inserter(popped), 10) == 0);
+    }
+
+    SECTION("pop_bulk waits for items")
+    {
+        vector<int> popped;
+
+        thread thd{[&tsq, &popped] { tsq.pop_bulk(back_inserter(popped), 64); }};
+
+        this_thread::sleep_for(100ms);
+        tsq.push(1);
+        thd.join();
+
+        REQUIRE(popped == vector<int>{1});
+    }
+}
+
+TEST_CASE("ThreadSafeQueue - timed and cancellable waits")
+{
+    ThreadSafeQueue<int> tsq;
+    int item = 0;
+
+    SECTION("pop_for times out when empty")
+    {
+        REQUIRE(tsq.pop_for(item, 50ms) == QueueStatus::timeout);
+    }
+
+    SECTION("pop_until returns item pushed before deadline")
+    {
+        tsq.push(1);
+
+        REQUIRE(tsq.pop_until(item, chrono::steady_clock::now() + 50ms) == QueueStatus::success);
+        REQUIRE(item == 1);
+    }
+
+    SECTION("items pushed before close can be drained")
+    {
+        tsq.push({1, 2});
+        tsq.close();
+
+        REQUIRE(tsq.done() == false);
+        REQUIRE(tsq.pop(item) == true);
+        REQUIRE(tsq.pop_for(item, 50ms) == QueueStatus::success);
+        REQUIRE(item == 2);
+        REQUIRE(tsq.pop(item) == false);
+        REQUIRE(tsq.pop_for(item, 50ms) == QueueStatus::closed);
+        REQUIRE(tsq.done() == true);
+    }
+
+    SECTION("push to closed queue throws")
+    {
+        tsq.close();
+
+        REQUIRE_THROWS_AS(tsq.push(1), std::logic_error);
+        REQUIRE(tsq.try_push(1) == false);
+    }
+
+    SECTION("close wakes all waiting consumers")
+    {
+        const int size = 3;
+
+        vector<QueueStatus> results(size, QueueStatus::success);
+        vector<thread> threads;
+
+        for (int i = 0; i < size; ++i)
+            threads.emplace_back([&tsq, &results, i] {
+                int item;
+                results[i] = tsq.pop_for(item, 10s);
+            });
+
+        this_thread::sleep_for(100ms);
+        tsq.close();
+
+        for (auto& thd : threads)
+            thd.join();
+
+        REQUIRE(all_of(results.begin(), results.end(), [](QueueStatus s) { return s == QueueStatus::closed; }));
+    }
+}
+
+struct NoDefault
+{
+    string name;
+    int value;
+
+    NoDefault(string name, int value)
+        : name{move(name)}
+        , value{value}
+    {
+    }
+};
+
+TEST_CASE("ThreadSafeQueue - move-only and in-place items")
+{
+    SECTION("emplace constructs item in place")
+    {
+        ThreadSafeQueue<NoDefault> q;
+        q.emplace("one", 1);
+
+        auto item = q.pop();
+
+        REQUIRE(item.has_value());
+        REQUIRE(item->name == "one");
+        REQUIRE(item->value == 1);
+    }
+
+    SECTION("pop returns move-only item by value")
+    {
+        ThreadSafeQueue<unique_ptr<string>> q;
+        q.emplace(make_unique<string>("gadget"));
+
+        optional<unique_ptr<string>> item = q.pop();
+
+        REQUIRE(**item == "gadget");
+        REQUIRE(q.try_pop() == nullopt);
+    }
+
+    SECTION("try_push moves item only on success")
+    {
+        ThreadSafeQueue<unique_ptr<int>> q;
+        auto item = make_unique<int>(1);
+
+        REQUIRE(q.try_push(move(item)));
+        REQUIRE(item == nullptr);
+
+        q.close();
+        auto rejected = make_unique<int>(2);
+
+        REQUIRE(q.try_push(move(rejected)) == false);
+        REQUIRE(rejected != nullptr);
+    }
+
+    SECTION("pop returns empty optional when closed and drained")
+    {
+        ThreadSafeQueue<int> q;
+        q.push(1);
+        q.close();
+
+        REQUIRE(q.pop() == 1);
+        REQUIRE(q.pop() == nullopt);
+    }
+}
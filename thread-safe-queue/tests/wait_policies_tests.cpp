@@ -0,0 +1,93 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "catch.hpp"
+#include "thread_safe_queue.hpp"
+#include "wait_policies.hpp"
+
+using namespace std;
+
+TEMPLATE_TEST_CASE("ThreadSafeQueue - wait policies", "", CvWait, SpinThenParkWait)
+{
+    ThreadSafeQueue<int, NoQueueStats, TestType> q;
+    int item = 0;
+
+    SECTION("waiting consumer is woken by push")
+    {
+        thread consumer{[&q, &item] { q.pop(item); }};
+
+        this_thread::sleep_for(100ms);
+        q.push(42);
+        consumer.join();
+
+        REQUIRE(item == 42);
+    }
+
+    SECTION("pop_for times out when empty")
+    {
+        REQUIRE(q.pop_for(item, 50ms) == QueueStatus::timeout);
+    }
+
+    SECTION("pop_for returns item pushed while waiting")
+    {
+        thread producer{[&q] {
+            this_thread::sleep_for(50ms);
+            q.push(1);
+        }};
+
+        REQUIRE(q.pop_for(item, 10s) == QueueStatus::success);
+        REQUIRE(item == 1);
+        producer.join();
+    }
+
+    SECTION("close wakes all waiting consumers")
+    {
+        vector<int> results(3, 1);
+        vector<thread> consumers;
+
+        for (size_t i = 0; i < results.size(); ++i)
+            consumers.emplace_back([&q, &results, i] {
+                int item;
+                results[i] = q.pop(item);
+            });
+
+        this_thread::sleep_for(100ms);
+        q.close();
+
+        for (auto& thd : consumers)
+            thd.join();
+
+        REQUIRE(none_of(results.begin(), results.end(), [](int r) { return r; }));
+    }
+
+    SECTION("many producers and consumers transfer all items")
+    {
+        const int items_per_producer = 10'000;
+        atomic<long> sum{0};
+        vector<thread> threads;
+
+        for (int p = 0; p < 4; ++p)
+            threads.emplace_back([&q] {
+                for (int i = 1; i <= items_per_producer; ++i)
+                    q.push(i);
+            });
+
+        for (int c = 0; c < 4; ++c)
+            threads.emplace_back([&q, &sum] {
+                int item{};
+                for (int i = 0; i < items_per_producer; ++i)
+                {
+                    q.pop(item);
+                    sum += item;
+                }
+            });
+
+        for (auto& thd : threads)
+            thd.join();
+
+        REQUIRE(sum == 4L * items_per_producer * (items_per_producer + 1) / 2);
+    }
+}
@@ -0,0 +1,154 @@
+#include <atomic>
+#include <future>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "catch.hpp"
+#include "work_stealing_deque.hpp"
+#include "work_stealing_pool.hpp"
+
+using namespace std;
+
+TEST_CASE("WorkStealingDeque")
+{
+    WorkStealingDeque<int> dq{2};
+
+    SECTION("is empty after creation")
+    {
+        REQUIRE(dq.empty() == true);
+    }
+
+    SECTION("owner pops LIFO")
+    {
+        dq.push(1);
+        dq.push(2);
+
+        int item;
+        REQUIRE(dq.pop(item));
+        REQUIRE(item == 2);
+    }
+
+    SECTION("thief steals FIFO")
+    {
+        dq.push(1);
+        dq.push(2);
+
+        int item;
+        REQUIRE(dq.steal(item));
+        REQUIRE(item == 1);
+    }
+
+    SECTION("grows beyond initial capacity")
+    {
+        for (int i = 0; i < 100; ++i)
+            dq.push(i);
+
+        int item;
+        for (int i = 99; i >= 0; --i)
+        {
+            REQUIRE(dq.pop(item));
+            REQUIRE(item == i);
+        }
+
+        REQUIRE(dq.pop(item) == false);
+    }
+
+    SECTION("every item is taken exactly once by owner and thieves")
+    {
+        const int no_of_items = 100'000;
+        atomic<bool> done{false};
+        vector<vector<int>> stolen(3);
+        vector<thread> thieves;
+
+        for (auto& s : stolen)
+            thieves.emplace_back([&dq, &done, &s] {
+                int item;
+                while (!done || !dq.empty())
+                    if (dq.steal(item))
+                        s.push_back(item);
+            });
+
+        vector<int> popped;
+        int item;
+        for (int i = 0; i < no_of_items; ++i)
+        {
+            dq.push(i);
+            if (i % 3 == 0 && dq.pop(item))
+                popped.push_back(item);
+        }
+        while (dq.pop(item))
+            popped.push_back(item);
+
+        done = true;
+        for (auto& thd : thieves)
+            thd.join();
+
+        set<int> all(popped.begin(), popped.end());
+        size_t total = popped.size();
+        for (const auto& s : stolen)
+        {
+            all.insert(s.begin(), s.end());
+            total += s.size();
+        }
+
+        REQUIRE(total == no_of_items);
+        REQUIRE(all.size() == no_of_items);
+    }
+}
+
+long fibonacci(WorkStealingPool& pool, int n)
+{
+    if (n < 16)
+        return n < 2 ? n : fibonacci(pool, n - 1) + fibonacci(pool, n - 2);
+
+    auto f1 = pool.submit(fibonacci, ref(pool), n - 1);
+    const long f2 = fibonacci(pool, n - 2);
+    pool.wait(f1);
+
+    return f1.get() + f2;
+}
+
+TEST_CASE("WorkStealingPool")
+{
+    WorkStealingPool pool{4};
+
+    SECTION("submit returns future with result")
+    {
+        auto f = pool.submit([](int x) { return x * x; }, 7);
+
+        REQUIRE(f.get() == 49);
+    }
+
+    SECTION("exception is propagated through future")
+    {
+        auto f = pool.submit([] { throw runtime_error("Error#13"); });
+
+        REQUIRE_THROWS_AS(f.get(), runtime_error);
+    }
+
+    SECTION("tasks can fork and join subtasks")
+    {
+        auto f = pool.submit(fibonacci, ref(pool), 25);
+
+        REQUIRE(f.get() == 75025);
+    }
+}
+
+TEST_CASE("WorkStealingPool - destructor runs queued tasks")
+{
+    atomic<int> counter{0};
+
+    {
+        WorkStealingPool pool{2};
+
+        for (int i = 0; i < 1000; ++i)
+            pool.submit([&pool, &counter] {
+                pool.submit([&counter] { ++counter; });
+                ++counter;
+            });
+    }
+
+    REQUIRE(counter == 2000);
+}
@@ -0,0 +1,327 @@
+#ifndef ASYNC_LOGGER_HPP
+#define ASYNC_LOGGER_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "concurrency_utils.hpp"
+
+// Asynchronous logger: log() copies the format string pointer and the raw argument values into
+// a fixed-size binary record in the calling thread's own ring buffer (no locks, no formatting, no I/O).
+// A background writer thread drains all buffers, formats the records ("{}" is replaced by the next argument)
+// and writes them to the output stream. When a thread's buffer is full the record is dropped and counted.
+// Records logged by one thread keep their order; records of different threads are not ordered.
+// When a thread exits, its buffer is written out and freed by the writer, so threads may come and go.
+// A thread that logs to several loggers keeps a separate buffer in each of them.
+//
+//   AsyncLogger logger;
+//   logger.log("THD#{} transfer from ba#{} to ba#{}", thd_id, from.id(), to.id());
+class AsyncLogger
+{
+    static constexpr size_t cache_line_size = 64;
+    static constexpr size_t max_args_size = 48;
+
+    using Formatter = void (*)(std::ostream&, const char*, const void*);
+
+    struct Record
+    {
+        Formatter format;
+        const char* fmt;
+        alignas(std::max_align_t) unsigned char args[max_args_size];
+    };
+
+    // single producer (the owning thread) / single consumer (whoever holds drain_mtx_) ring
+    struct alignas(cache_line_size) ThreadBuffer
+    {
+        const size_t mask;
+        std::unique_ptr<Record[]> records;
+        std::atomic<bool> is_released{false}; // the owning thread will not log to it any more
+        std::atomic<bool> is_orphaned{false}; // the logger is gone; the owning thread drops its handle
+        alignas(cache_line_size) std::atomic<size_t> head{0}; // next record to format
+        alignas(cache_line_size) std::atomic<size_t> tail{0}; // next free slot
+
+        explicit ThreadBuffer(size_t capacity)
+            : mask{capacity - 1}
+            , records{new Record[capacity]}
+        {
+        }
+    };
+
+    // the calling thread's buffer in one logger; shares the buffer with the logger,
+    // so whichever of the thread and the logger ends last frees it
+    struct BufferHandle
+    {
+        uint64_t logger_id = 0;
+        std::shared_ptr<ThreadBuffer> buffer;
+
+        BufferHandle(uint64_t logger_id, std::shared_ptr<ThreadBuffer> buffer)
+            : logger_id{logger_id}
+            , buffer{std::move(buffer)}
+        {
+        }
+
+        BufferHandle(const BufferHandle&) = delete;
+        BufferHandle& operator=(const BufferHandle&) = delete;
+
+        BufferHandle(BufferHandle&&) = default;
+
+        BufferHandle& operator=(BufferHandle&& other)
+        {
+            release();
+            logger_id = other.logger_id;
+            buffer = std::move(other.buffer);
+            return *this;
+        }
+
+        // at thread exit - the writer formats the remaining records and then frees the buffer
+        ~BufferHandle()
+        {
+            release();
+        }
+
+        void release()
+        {
+            if (buffer)
+                buffer->is_released.store(true, std::memory_order_release);
+            buffer.reset();
+        }
+    };
+
+    std::ostream& out_;
+    const size_t buffer_capacity_;
+    const uint64_t id_;
+
+    std::mutex buffers_mtx_;
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers_;
+
+    std::mutex drain_mtx_;
+    std::atomic<uint64_t> dropped_{0};
+
+    std::mutex writer_mtx_;
+    std::condition_variable writer_cv_;
+    bool is_stopping_ = false;
+    std::thread writer_;
+
+    static uint64_t next_logger_id()
+    {
+        static std::atomic<uint64_t> next_id{1};
+        return next_id++;
+    }
+
+    // prints fmt up to the next "{}" and then the value
+    template <typename Arg>
+    static void write_arg_(std::ostream& out, const char*& fmt, const Arg& value)
+    {
+        while (*fmt && !(fmt[0] == '{' && fmt[1] == '}'))
+            out << *fmt++;
+
+        out << value;
+
+        if (*fmt)
+            fmt += 2;
+    }
+
+    template <typename... Args>
+    static void format_(std::ostream& out, const char* fmt, const void* args)
+    {
+        const auto& values = *static_cast<const std::tuple<Args...>*>(args);
+        std::apply([&](const auto&... value) { (write_arg_(out, fmt, value), ...); }, values);
+        out << fmt << '\n';
+    }
+
+    std::shared_ptr<ThreadBuffer> register_buffer_()
+    {
+        auto buffer = std::make_shared<ThreadBuffer>(buffer_capacity_);
+
+        std::lock_guard<std::mutex> lk{buffers_mtx_};
+        buffers_.push_back(buffer);
+
+        return buffer;
+    }
+
+    // a thread keeps one handle per logger it has used (usually very few, so a vector is enough);
+    // handles of destroyed loggers are dropped when the thread registers a new buffer
+    ThreadBuffer& own_buffer_()
+    {
+        static thread_local std::vector<BufferHandle> handles;
+
+        for (BufferHandle& handle : handles)
+            if (handle.logger_id == id_)
+                return *handle.buffer;
+
+        handles.erase(std::remove_if(handles.begin(), handles.end(),
+                          [](const BufferHandle& handle) { return handle.buffer->is_orphaned.load(std::memory_order_relaxed); }),
+            handles.end());
+
+        handles.emplace_back(id_, register_buffer_());
+
+        return *handles.back().buffer;
+    }
+
+    // returns true when any record was written
+    bool drain_()
+    {
+        std::lock_guard<std::mutex> drain_lk{drain_mtx_};
+
+        std::vector<ThreadBuffer*> buffers;
+        {
+            std::lock_guard<std::mutex> lk{buffers_mtx_};
+            for (auto& buffer : buffers_)
+                buffers.push_back(buffer.get());
+        }
+
+        bool has_released = false;
+        bool has_written = false;
+        for (ThreadBuffer* buffer : buffers)
+        {
+            // read before tail: a released buffer gets no more records, so draining it up to tail empties it for good
+            const bool is_released = buffer->is_released.load(std::memory_order_acquire);
+            has_released = has_released || is_released;
+
+            const size_t head = buffer->head.load(std::memory_order_relaxed);
+            const size_t tail = buffer->tail.load(std::memory_order_acquire);
+
+            for (size_t i = head; i != tail; ++i)
+            {
+                const Record& record = buffer->records[i & buffer->mask];
+                record.format(out_, record.fmt, record.args);
+            }
+
+            buffer->head.store(tail, std::memory_order_release);
+            has_written = has_written || head != tail;
+        }
+
+        if (has_written)
+            out_.flush();
+
+        if (has_released)
+        {
+            std::lock_guard<std::mutex> lk{buffers_mtx_};
+            buffers_.erase(std::remove_if(buffers_.begin(), buffers_.end(),
+                               [](const auto& buffer) {
+                                   return buffer->is_released.load(std::memory_order_acquire)
+                                       && buffer->head.load(std::memory_order_relaxed) == buffer->tail.load(std::memory_order_acquire);
+                               }),
+                buffers_.end());
+        }
+
+        return has_written;
+    }
+
+    void run_writer_(std::chrono::milliseconds flush_interval)
+    {
+        std::unique_lock<std::mutex> lk{writer_mtx_};
+
+        while (!is_stopping_)
+        {
+            lk.unlock();
+            const bool has_written = drain_();
+            lk.lock();
+
+            if (!has_written)
+                writer_cv_.wait_for(lk, flush_interval, [this] { return is_stopping_; });
+        }
+    }
+
+public:
+    // buffer_capacity - records buffered per logging thread before log() starts dropping
+    explicit AsyncLogger(std::ostream& out = std::cout, size_t buffer_capacity = 16 * 1024,
+        std::chrono::milliseconds flush_interval = std::chrono::milliseconds{1})
+        : out_{out}
+        , buffer_capacity_{round_up_to_power_of_2(buffer_capacity)}
+        , id_{next_logger_id()}
+    {
+        writer_ = std::thread{[this, flush_interval] { run_writer_(flush_interval); }};
+    }
+
+    AsyncLogger(const AsyncLogger&) = delete;
+    AsyncLogger& operator=(const AsyncLogger&) = delete;
+
+    // writes out everything logged before
+    ~AsyncLogger()
+    {
+        {
+            std::lock_guard<std::mutex> lk{writer_mtx_};
+            is_stopping_ = true;
+        }
+        writer_cv_.notify_one();
+        writer_.join();
+
+        drain_();
+
+        std::lock_guard<std::mutex> lk{buffers_mtx_};
+        for (auto& buffer : buffers_)
+            buffer->is_orphaned.store(true, std::memory_order_relaxed);
+    }
+
+    // fmt must outlive the logger (a string literal); arguments are copied, so they must be
+    // trivially copyable (numbers, pointers to static strings) and fit into one record.
+    // Returns false when the record was dropped because the thread's buffer is full.
+    template <typename... Args>
+    bool log(const char* fmt, const Args&... args)
+    {
+        using Values = std::tuple<std::decay_t<Args>...>;
+        static_assert(sizeof(Values) <= max_args_size, "too many arguments for one log record");
+        static_assert((std::is_trivially_copyable<std::decay_t<Args>>::value && ...), "log arguments must be trivially copyable");
+
+        ThreadBuffer& buffer = own_buffer_();
+
+        const size_t tail = buffer.tail.load(std::memory_order_relaxed);
+        if (tail - buffer.head.load(std::memory_order_acquire) > buffer.mask)
+        {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        Record& record = buffer.records[tail & buffer.mask];
+        record.format = &format_<std::decay_t<Args>...>;
+        record.fmt = fmt;
+        new (record.args) Values{args...};
+
+        buffer.tail.store(tail + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    // blocks until every record logged so far by the calling thread (and the ones already
+    // buffered by other threads) is written
+    void flush()
+    {
+        drain_();
+    }
+
+    // number of records dropped because a buffer was full
+    uint64_t dropped() const
+    {
+        return dropped_.load(std::memory_order_relaxed);
+    }
+
+    // buffers of threads that use the logger, plus those of exited threads not yet written out
+    size_t no_of_buffers()
+    {
+        std::lock_guard<std::mutex> lk{buffers_mtx_};
+        return buffers_.size();
+    }
+};
+
+// shared by all threads - logging never blocks them on std::cout
+inline AsyncLogger& logger()
+{
+    static AsyncLogger logger;
+    return logger;
+}
+
+#endif // ASYNC_LOGGER_HPP
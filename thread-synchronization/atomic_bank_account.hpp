@@ -0,0 +1,102 @@
+#ifndef ATOMIC_BANK_ACCOUNT_HPP
+#define ATOMIC_BANK_ACCOUNT_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <utility>
+
+#include "async_logger.hpp"
+#include "money.hpp"
+
+// BankAccount without a mutex on the hot path: the balance is a single std::atomic<Cents>, so deposit is
+// one fetch_add, withdraw is a CAS loop that refuses to overdraw and balance() is a plain load.
+// The balance does not guard any other data, so relaxed ordering is enough.
+// Only operations on two accounts take a mutex: transfer() and balances() lock both accounts,
+// so a transfer is never seen half done by them; move_funds_eventually() is the lock-free variant.
+class AtomicBankAccount
+{
+    static constexpr size_t cache_line_size = 64;
+
+    const int id_;
+    alignas(cache_line_size) std::atomic<Cents> balance_; // accounts updated by different threads don't share a line
+    mutable std::mutex pair_mtx_; // serializes transfer() and balances() - single-account operations never take it
+
+public:
+    AtomicBankAccount(int id, Cents balance)
+        : id_(id)
+        , balance_(balance)
+    {
+    }
+
+    AtomicBankAccount(const AtomicBankAccount&) = delete;
+    AtomicBankAccount& operator=(const AtomicBankAccount&) = delete;
+
+    void print() const
+    {
+        logger().log("Bank Account #{}; Balance = {}", id(), balance());
+    }
+
+    // locks both accounts (deadlock free), so balances() never sees the amount missing from both of them;
+    // returns false (and moves nothing) when this balance is lower than amount
+    bool transfer(AtomicBankAccount& to, Cents amount)
+    {
+        std::unique_lock<std::mutex> lk_from{pair_mtx_, std::defer_lock};
+        std::unique_lock<std::mutex> lk_to{to.pair_mtx_, std::defer_lock};
+        std::lock(lk_from, lk_to);
+
+        return move_funds_eventually(to, amount);
+    }
+
+    // Lock-free transfer: withdraws from this account first and only then deposits to the other one -
+    // the money is never spent twice and the sum of both balances is exact once concurrent moves have
+    // finished, but any reader running in between (balances() included) may see the amount missing from both.
+    bool move_funds_eventually(AtomicBankAccount& to, Cents amount)
+    {
+        if (!withdraw(amount))
+            return false;
+
+        to.deposit(amount);
+        return true;
+    }
+
+    // consistent with transfer(): a snapshot of both balances taken with both accounts locked
+    static std::pair<Cents, Cents> balances(const AtomicBankAccount& a, const AtomicBankAccount& b)
+    {
+        std::unique_lock<std::mutex> lk_a{a.pair_mtx_, std::defer_lock};
+        std::unique_lock<std::mutex> lk_b{b.pair_mtx_, std::defer_lock};
+        std::lock(lk_a, lk_b);
+
+        return {a.balance(), b.balance()};
+    }
+
+    // returns false (and leaves the balance unchanged) when the balance is lower than amount
+    bool withdraw(Cents amount)
+    {
+        Cents current = balance_.load(std::memory_order_relaxed);
+        do
+        {
+            if (current < amount)
+                return false;
+        } while (!balance_.compare_exchange_weak(current, current - amount, std::memory_order_relaxed));
+
+        return true;
+    }
+
+    void deposit(Cents amount)
+    {
+        balance_.fetch_add(amount, std::memory_order_relaxed);
+    }
+
+    int id() const
+    {
+        return id_;
+    }
+
+    Cents balance() const
+    {
+        return balance_.load(std::memory_order_relaxed);
+    }
+};
+
+#endif // ATOMIC_BANK_ACCOUNT_HPP
@@ -1,48 +1,109 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <iterator>
 #include <iostream>
-#include <thread>
+#include <map>
 #include <mutex>
+#include <numeric>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
 
-class BankAccount
+#include "async_logger.hpp"
+#include "atomic_bank_account.hpp"
+#include "debug_mutex.hpp"
+#include "hot_bank_account.hpp"
+#include "journal.hpp"
+#include "ledger.hpp"
+#include "seqlock_bank_account.hpp"
+#include "stm.hpp"
+
+// Mutex - DefaultMutex checks the lock order of the account operations in debug builds;
+// std::mutex always skips the checks
+template <typename Mutex = DefaultMutex>
+class BasicBankAccount
 {
     const int id_;
     double balance_;
-    mutable std::mutex mtx_;
+    mutable Mutex mtx_;
+    Journal* journal_; // optional - every operation is appended and committed when set
+
+    // called with the account(s) locked, before the balance changes, so that the journal order
+    // of operations on an account matches the order in which they were applied
+    uint64_t log_(JournalOp op, int other_account, double amount)
+    {
+        return journal_ ? journal_->append(op, id_, other_account, amount) : 0;
+    }
+
+    // called after unlocking - threads waiting for the disk share one sync (group commit)
+    void commit_(uint64_t sequence)
+    {
+        if (journal_)
+            journal_->commit(sequence);
+    }
 
 public:
-    BankAccount(int id, double balance)
+    BasicBankAccount(int id, double balance, Journal* journal = nullptr)
         : id_(id)
         , balance_(balance)
+        , journal_(journal)
     {
+        commit_(log_(JournalOp::open_account, 0, balance));
     }
 
     void print() const
     {
-        std::cout << "Bank Account #" << id() << "; Balance = " << balance() << std::endl;
+        logger().log("Bank Account #{}; Balance = {}", id(), balance());
     }
 
-    void transfer(BankAccount& to, double amount)
+    void transfer(BasicBankAccount& to, double amount)
     {
-        std::unique_lock<std::mutex> lk_from{mtx_, std::defer_lock};
-        std::unique_lock<std::mutex> lk_to{to.mtx_, std::defer_lock};
-        std::lock(lk_from, lk_to); // deadlock free code
+        uint64_t sequence;
+        {
+            std::unique_lock<Mutex> lk_from{mtx_, std::defer_lock};
+            std::unique_lock<Mutex> lk_to{to.mtx_, std::defer_lock};
+            std::lock(lk_from, lk_to); // deadlock free code
+
+            // C++17
+            //std::scoped_lock lk{mtx_, to.mtx_};
 
-        // C++17
-        //std::scoped_lock lk{mtx_, to.mtx_};
+            sequence = log_(JournalOp::transfer, to.id_, amount);
+            balance_ -= amount;
+            to.balance_ += amount;
+        }
 
-        balance_ -= amount;
-        to.balance_ += amount;
+        commit_(sequence);
     }
 
     void withdraw(double amount)
     {
-        std::lock_guard<std::mutex> lk{mtx_};
-        balance_ -= amount;
+        uint64_t sequence;
+        {
+            std::lock_guard<Mutex> lk{mtx_};
+            sequence = log_(JournalOp::withdraw, 0, amount);
+            balance_ -= amount;
+        }
+
+        commit_(sequence);
     }
 
     void deposit(double amount)
     {
-        std::lock_guard<std::mutex> lk{mtx_};
-        balance_ += amount;
+        uint64_t sequence;
+        {
+            std::lock_guard<Mutex> lk{mtx_};
+            sequence = log_(JournalOp::deposit, 0, amount);
+            balance_ += amount;
+        }
+
+        commit_(sequence);
     }
 
     int id() const
@@ -52,53 +113,59 @@ public:
 
     double balance() const
     {
-        std::lock_guard<std::mutex> lk{mtx_};
+        std::lock_guard<Mutex> lk{mtx_};
         return balance_;
     }
 };
 
-void make_withdraws(BankAccount& ba, int no_of_operations)
+using BankAccount = BasicBankAccount<>;
+using StdMutexBankAccount = BasicBankAccount<std::mutex>; // baseline of the benchmarks in any build
+
+template <typename Account>
+void make_withdraws(Account& ba, int no_of_operations)
 {
     for (int i = 0; i < no_of_operations; ++i)
-        ba.withdraw(1.0);
+        ba.withdraw(1);
 }
 
-void make_deposits(BankAccount& ba, int no_of_operations)
+template <typename Account>
+void make_deposits(Account& ba, int no_of_operations)
 {
     for (int i = 0; i < no_of_operations; ++i)
-        ba.deposit(1.0);
+        ba.deposit(1);
 }
 
 void make_transfers(BankAccount& from, BankAccount& to, int no_of_operations, int thd_id)
 {
     for (int i = 0; i < no_of_operations; ++i)
     {
-        std::cout << "THD#" << thd_id << " transfer from ba#" << from.id()
-                  << " to ba#" << to.id() << std::endl;
+        logger().log("THD#{} transfer from ba#{} to ba#{}", thd_id, from.id(), to.id());
 
         from.transfer(to, 1.0);
     }
 }
 
 
-int main()
+bool demo_bank_account()
 {
     const int no_of_iterations = 10'000;
 
     BankAccount ba1(1, 10'000);
     BankAccount ba2(2, 10'000);
 
-    std::thread thd1(&make_withdraws, std::ref(ba1), no_of_iterations);
-    std::thread thd2(&make_deposits, std::ref(ba1), no_of_iterations);
+    std::thread thd1(&make_withdraws<BankAccount>, std::ref(ba1), no_of_iterations);
+    std::thread thd2(&make_deposits<BankAccount>, std::ref(ba1), no_of_iterations);
 
     thd1.join();
     thd2.join();
 
-    std::cout << "After threads:\n";
+    const bool is_balance_preserved = ba1.balance() == 10'000;
+
+    logger().log("After threads:");
     ba1.print();
     ba2.print();
 
-    std::cout << "\nTransfer:" << std::endl;
+    logger().log("\nTransfer:");
 
     std::thread thd3(&make_transfers, std::ref(ba1), std::ref(ba2), no_of_iterations, 1);
     std::thread thd4(&make_transfers, std::ref(ba2), std::ref(ba1), no_of_iterations, 2);
@@ -106,11 +173,774 @@ int main()
     thd3.join();
     thd4.join();
 
+    logger().flush(); // records of different threads are not ordered - write out the transfers first
+
     ba1.print();
     ba2.print();
+
+    logger().flush();
+    if (logger().dropped() > 0)
+        std::cout << "(" << logger().dropped() << " log records dropped)" << std::endl;
+
+    const bool is_total_preserved = ba1.balance() + ba2.balance() == 20'000;
+    std::cout << "Bank accounts: balances " << (is_balance_preserved && is_total_preserved ? "preserved" : "CORRUPTED") << std::endl;
+
+    return is_balance_preserved && is_total_preserved;
+}
+
+bool demo_async_logger()
+{
+    const int no_of_threads = 1'000;
+    const int no_of_records = 10;
+
+    std::ostringstream out;
+    size_t no_of_buffers;
+    {
+        AsyncLogger log{out, 64};
+
+        // short-lived threads, a few at a time - each one's buffer is freed after it exits
+        for (int t = 0; t < no_of_threads; t += 4)
+        {
+            std::vector<std::thread> threads;
+            for (int k = t; k < t + 4; ++k)
+                threads.emplace_back([&log, k, no_of_records] {
+                    for (int i = 0; i < no_of_records; ++i)
+                        log.log("THD#{} record #{}", k, i);
+                });
+
+            for (auto& thd : threads)
+                thd.join();
+        }
+
+        log.flush();
+        no_of_buffers = log.no_of_buffers();
+    }
+
+    const std::string text = out.str();
+    const auto no_of_lines = std::count(text.begin(), text.end(), '\n');
+    const bool is_ok = no_of_lines == no_of_threads * no_of_records && no_of_buffers == 0;
+
+    std::cout << "AsyncLogger: " << no_of_lines << " records from " << no_of_threads << " threads; " << no_of_buffers
+              << " thread buffers left - " << (is_ok ? "correct" : "LEAKED") << std::endl;
+
+    // one thread alternating between two loggers keeps one buffer in each of them
+    std::ostringstream out1, out2;
+    size_t no_of_buffers1, no_of_buffers2;
+    {
+        AsyncLogger log1{out1, 64};
+        AsyncLogger log2{out2, 64};
+
+        for (int i = 0; i < no_of_records; ++i)
+        {
+            log1.log("log1 record #{}", i);
+            log2.log("log2 record #{}", i);
+        }
+
+        log1.flush();
+        log2.flush();
+        no_of_buffers1 = log1.no_of_buffers();
+        no_of_buffers2 = log2.no_of_buffers();
+    }
+
+    const std::string text1 = out1.str();
+    const std::string text2 = out2.str();
+    const bool is_alternating_ok = no_of_buffers1 == 1 && no_of_buffers2 == 1
+        && std::count(text1.begin(), text1.end(), '\n') == no_of_records
+        && std::count(text2.begin(), text2.end(), '\n') == no_of_records;
+
+    std::cout << "AsyncLogger: two loggers used alternately keep " << no_of_buffers1 << " + " << no_of_buffers2
+              << " buffers - " << (is_alternating_ok ? "correct" : "CHURNED") << std::endl;
+
+    return is_ok && is_alternating_ok;
+}
+
+// runs make_withdraws and make_deposits on one account from no_of_threads threads each;
+// returns operations per second
+template <typename Account>
+double benchmark_deposits_withdraws(Account& ba, int no_of_operations, unsigned no_of_threads)
+{
+    auto start = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> threads;
+    for (unsigned t = 0; t < no_of_threads; ++t)
+    {
+        threads.emplace_back(&make_withdraws<Account>, std::ref(ba), no_of_operations);
+        threads.emplace_back(&make_deposits<Account>, std::ref(ba), no_of_operations);
+    }
+
+    for (auto& thd : threads)
+        thd.join();
+
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    return 2.0 * no_of_threads * no_of_operations / elapsed.count();
+}
+
+bool demo_atomic_bank_account()
+{
+    const int no_of_operations = 1'000'000;
+    const Cents initial_balance = 100'000'000'00;
+    const unsigned no_of_threads = std::max(1u, std::thread::hardware_concurrency() / 2);
+
+    StdMutexBankAccount mutex_account(1, initial_balance);
+    AtomicBankAccount atomic_account(2, initial_balance);
+
+    const double mutex_ops = benchmark_deposits_withdraws(mutex_account, no_of_operations, no_of_threads);
+    const double atomic_ops = benchmark_deposits_withdraws(atomic_account, no_of_operations, no_of_threads);
+
+    const bool is_balance_preserved = mutex_account.balance() == initial_balance && atomic_account.balance() == initial_balance;
+
+    std::cout << "Deposits/withdraws on " << 2 * no_of_threads << " threads - BankAccount: " << mutex_ops << " ops/s; "
+              << "AtomicBankAccount: " << atomic_ops << " ops/s; balances " << (is_balance_preserved ? "preserved" : "CORRUPTED")
+              << std::endl;
+
+    AtomicBankAccount ba1(1, 10'000);
+    AtomicBankAccount ba2(2, 10'000);
+    const int no_of_transfers = no_of_operations / 10;
+
+    // locked transfers - every snapshot taken meanwhile sums up to the total
+    std::atomic<bool> is_done{false};
+    bool is_atomic = true; // written by the auditor only, read after joining it
+    std::thread auditor([&] {
+        while (!is_done)
+        {
+            const auto [b1, b2] = AtomicBankAccount::balances(ba1, ba2);
+            is_atomic = is_atomic && b1 + b2 == 20'000;
+        }
+    });
+
+    auto make_transfers = [no_of_transfers](AtomicBankAccount& from, AtomicBankAccount& to) {
+        for (int i = 0; i < no_of_transfers; ++i)
+            from.transfer(to, 1);
+    };
+
+    std::thread thd1(make_transfers, std::ref(ba1), std::ref(ba2));
+    std::thread thd2(make_transfers, std::ref(ba2), std::ref(ba1));
+
+    thd1.join();
+    thd2.join();
+    is_done = true;
+    auditor.join();
+
+    // lock-free moves - the total is exact once they have finished
+    auto move_funds = [no_of_operations](AtomicBankAccount& from, AtomicBankAccount& to) {
+        for (int i = 0; i < no_of_operations; ++i)
+            from.move_funds_eventually(to, 1);
+    };
+
+    std::thread thd3(move_funds, std::ref(ba1), std::ref(ba2));
+    std::thread thd4(move_funds, std::ref(ba2), std::ref(ba1));
+
     thd3.join();
     thd4.join();
 
-    ba1.print();
-    ba2.print();
+    const bool is_total_preserved = ba1.balance() + ba2.balance() == 20'000 && ba1.balance() >= 0 && ba2.balance() >= 0;
+
+    std::cout << "AtomicBankAccount transfers: " << (is_atomic ? "atomic" : "SEEN HALF DONE") << "; moves: total balance "
+              << (is_total_preserved ? "preserved" : "CORRUPTED") << std::endl;
+
+    return is_balance_preserved && is_atomic && is_total_preserved;
+}
+
+// no_of_threads threads deposit to one account; returns deposits per second
+template <typename Account>
+double benchmark_deposits(Account& ba, int no_of_operations, unsigned no_of_threads)
+{
+    auto start = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> threads;
+    for (unsigned t = 0; t < no_of_threads; ++t)
+        threads.emplace_back(&make_deposits<Account>, std::ref(ba), no_of_operations);
+
+    for (auto& thd : threads)
+        thd.join();
+
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    return static_cast<double>(no_of_threads) * no_of_operations / elapsed.count();
+}
+
+bool demo_hot_account()
+{
+    const int no_of_operations = 1'000'000;
+    const Cents initial_balance = 100'000'000'00;
+    const unsigned no_of_threads = std::max(4u, std::thread::hardware_concurrency());
+
+    StdMutexBankAccount mutex_account(1, initial_balance);
+    HotBankAccount hot_account(2, initial_balance);
+
+    const double mutex_deposits = benchmark_deposits(mutex_account, no_of_operations, no_of_threads);
+    const double hot_deposits = benchmark_deposits(hot_account, no_of_operations, no_of_threads);
+
+    const double mutex_ops = benchmark_deposits_withdraws(mutex_account, no_of_operations, no_of_threads / 2);
+    const double hot_ops = benchmark_deposits_withdraws(hot_account, no_of_operations, no_of_threads / 2);
+
+    const Cents expected_balance = initial_balance + static_cast<Cents>(no_of_threads) * no_of_operations;
+
+    const bool is_balance_preserved = mutex_account.balance() == expected_balance && hot_account.balance() == expected_balance;
+
+    std::cout << "Hot account on " << no_of_threads << " threads - deposits: BankAccount " << mutex_deposits << " ops/s, "
+              << "HotBankAccount " << hot_deposits << " ops/s; deposits/withdraws: BankAccount " << mutex_ops << " ops/s, "
+              << "HotBankAccount " << hot_ops << " ops/s; balances " << (is_balance_preserved ? "preserved" : "CORRUPTED") << std::endl;
+
+    // withdraws that drain the account force rebalancing and must stop exactly at zero
+    HotBankAccount drained(3, 0);
+    benchmark_deposits(drained, 10'000, no_of_threads);
+
+    std::atomic<int> no_of_withdraws{0};
+    std::vector<std::thread> threads;
+    for (unsigned t = 0; t < no_of_threads; ++t)
+        threads.emplace_back([&] {
+            while (drained.withdraw(3))
+                ++no_of_withdraws;
+        });
+
+    for (auto& thd : threads)
+        thd.join();
+
+    const Cents deposited = static_cast<Cents>(no_of_threads) * 10'000;
+    const bool is_drained = no_of_withdraws * 3 + drained.balance() == deposited && drained.balance() < 3;
+
+    std::cout << "HotBankAccount drained: " << no_of_withdraws << " withdraws, balance " << drained.balance() << " - "
+              << (is_drained ? "correct" : "CORRUPTED") << std::endl;
+
+    return is_balance_preserved && is_drained;
+}
+
+bool demo_journal()
+{
+    const int no_of_operations = 2'000;
+    const unsigned no_of_threads = 8;
+    const auto path = std::filesystem::temp_directory_path() / "bank_account.journal";
+
+    std::filesystem::remove(path);
+
+    std::map<int32_t, double> balances;
+    uint64_t no_of_records;
+    uint64_t no_of_syncs;
+    std::chrono::duration<double> elapsed;
+    {
+        Journal journal{path.string()};
+        BankAccount ba1(1, 10'000, &journal);
+        BankAccount ba2(2, 10'000, &journal);
+
+        auto start = std::chrono::steady_clock::now();
+
+        std::vector<std::thread> threads;
+        for (unsigned t = 0; t < no_of_threads; ++t)
+            threads.emplace_back([&ba1, &ba2, t, no_of_operations] {
+                for (int i = 0; i < no_of_operations; ++i)
+                {
+                    switch ((i + t) % 3)
+                    {
+                    case 0:
+                        ba1.deposit(t + 1);
+                        break;
+                    case 1:
+                        ba2.withdraw(t + 1);
+                        break;
+                    default:
+                        (t % 2 == 0 ? ba1 : ba2).transfer(t % 2 == 0 ? ba2 : ba1, 1.0);
+                    }
+                }
+            });
+
+        for (auto& thd : threads)
+            thd.join();
+
+        elapsed = std::chrono::steady_clock::now() - start;
+        no_of_records = journal.size();
+        no_of_syncs = journal.no_of_syncs();
+        balances = {{1, ba1.balance()}, {2, ba2.balance()}};
+    }
+
+    // "startup": rebuild the balances from the file
+    Journal reopened{path.string()};
+    const auto replayed = replay_balances(reopened);
+
+    std::cout << "Journal: " << no_of_records << " records, " << no_of_syncs << " syncs, "
+              << (no_of_records - 2) / elapsed.count() << " durable ops/s; "
+              << "replayed balances " << (replayed == balances ? "match" : "DIFFER") << std::endl;
+
+    std::filesystem::remove(path);
+
+    return replayed == balances;
+}
+
+bool demo_lock_order()
+{
+    std::atomic<int> no_of_reports{0};
+    LockGraph::instance().set_handler([&no_of_reports](const std::string& report) {
+        ++no_of_reports;
+        std::cout << "  detected: " << report << std::endl;
+    });
+
+    DebugMutex mtx1{"account#1"};
+    DebugMutex mtx2{"account#2"};
+
+    std::cout << "Lock order:" << std::endl;
+
+    // BankAccount::transfer locks with std::lock - never reported in either direction
+    BasicBankAccount<DebugMutex> ba1(1, 10'000);
+    BasicBankAccount<DebugMutex> ba2(2, 10'000);
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t)
+        threads.emplace_back([&, t] {
+            for (int i = 0; i < 10'000; ++i)
+                t % 2 == 0 ? ba1.transfer(ba2, 1.0) : ba2.transfer(ba1, 1.0);
+        });
+
+    for (auto& thd : threads)
+        thd.join();
+
+    // nested locking in opposite orders - reported at the second acquisition although these threads don't deadlock
+    std::thread thd1([&] {
+        std::lock_guard<DebugMutex> lk1{mtx1};
+        std::lock_guard<DebugMutex> lk2{mtx2};
+    });
+    thd1.join();
+
+    std::thread thd2([&] {
+        std::lock_guard<DebugMutex> lk2{mtx2};
+        std::lock_guard<DebugMutex> lk1{mtx1};
+    });
+    thd2.join();
+
+    // locking a mutex the thread already holds throws instead of deadlocking
+    bool is_self_deadlock_detected = false;
+    {
+        std::lock_guard<DebugMutex> lk{mtx1};
+        try
+        {
+            mtx1.lock();
+        }
+        catch (const std::logic_error& e)
+        {
+            is_self_deadlock_detected = true;
+            std::cout << "  detected: " << e.what() << std::endl;
+        }
+    }
+
+    for (const auto& s : LockGraph::instance().stats())
+        std::cout << "  " << s.name << ": " << s.acquisitions << " acquisitions, " << s.contended << " contended, "
+                  << "wait " << std::chrono::duration<double, std::micro>(s.total_wait).count() << " us, "
+                  << "hold " << std::chrono::duration<double, std::micro>(s.total_hold).count() << " us (max "
+                  << std::chrono::duration<double, std::micro>(s.max_hold).count() << " us)" << std::endl;
+
+    std::cout << "  " << no_of_reports << " lock order problem(s) reported; self-deadlock "
+              << (is_self_deadlock_detected ? "detected" : "NOT DETECTED") << std::endl;
+
+    LockGraph::instance().set_handler([](const std::string& report) { std::cerr << report << std::endl; });
+
+    return no_of_reports == 1 && is_self_deadlock_detected;
+}
+
+bool demo_ledger()
+{
+    const size_t no_of_accounts = 1'000'000;
+    const Cents initial_balance = 100'00;
+    const int no_of_transfers = 1'000'000;
+    const unsigned no_of_threads = std::max(1u, std::thread::hardware_concurrency());
+
+    Ledger ledger(no_of_accounts, initial_balance);
+
+    auto start = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> threads;
+    for (unsigned t = 0; t < no_of_threads; ++t)
+        threads.emplace_back([&ledger, t, no_of_accounts, no_of_transfers, no_of_threads] {
+            std::mt19937_64 rnd{t};
+            std::uniform_int_distribution<AccountId> account(0, no_of_accounts - 1);
+
+            for (int i = 0; i < no_of_transfers / static_cast<int>(no_of_threads); ++i)
+                ledger.transfer(account(rnd), account(rnd), 1'00);
+        });
+
+    for (auto& thd : threads)
+        thd.join();
+
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    const bool is_total_preserved = ledger.total_balance() == initial_balance * static_cast<Cents>(no_of_accounts);
+
+    std::cout << "Ledger: " << no_of_transfers / elapsed.count() << " transfers/s on " << no_of_threads << " threads; "
+              << "total balance " << (is_total_preserved ? "preserved" : "CORRUPTED") << std::endl;
+
+    // zero and negative amounts must not move money
+    Ledger small(2, initial_balance);
+    int no_of_rejected = 0;
+    const std::function<void()> invalid_operations[] = {
+        [&] { small.transfer(0, 1, -50'00); },
+        [&] { small.transfer(0, 1, 0); },
+        [&] { small.withdraw(0, -50'00); },
+        [&] { small.deposit(0, -50'00); },
+        [&] { small.transfer_batch({Transfer{0, 1, 1'00}, Transfer{1, 0, -50'00}}); }};
+
+    for (const auto& operation : invalid_operations)
+        try
+        {
+            operation();
+        }
+        catch (const std::invalid_argument&)
+        {
+            ++no_of_rejected;
+        }
+
+    const bool is_rejected = no_of_rejected == static_cast<int>(std::size(invalid_operations))
+        && small.balance(0) == initial_balance && small.balance(1) == initial_balance;
+
+    std::cout << "Ledger: invalid amounts " << (is_rejected ? "rejected" : "ACCEPTED") << std::endl;
+
+    return is_total_preserved && is_rejected;
+}
+
+struct ReadWriteRates
+{
+    double reads_per_s;
+    double writes_per_s;
+};
+
+// no_of_readers threads poll balance() while no_of_writers threads deposit and withdraw
+template <typename Account>
+ReadWriteRates benchmark_reads_writes(Account& ba, unsigned no_of_readers, unsigned no_of_writers, std::chrono::milliseconds duration)
+{
+    std::atomic<bool> is_running{true};
+    std::atomic<uint64_t> no_of_reads{0};
+    std::atomic<uint64_t> no_of_writes{0};
+
+    std::vector<std::thread> threads;
+    for (unsigned t = 0; t < no_of_readers; ++t)
+        threads.emplace_back([&] {
+            uint64_t count = 0;
+            while (is_running)
+            {
+                ba.balance();
+                ++count;
+            }
+
+            no_of_reads += count;
+        });
+
+    for (unsigned t = 0; t < no_of_writers; ++t)
+        threads.emplace_back([&] {
+            uint64_t count = 0;
+            while (is_running)
+            {
+                ba.deposit(1);
+                ba.withdraw(1);
+                count += 2;
+            }
+
+            no_of_writes += count;
+        });
+
+    std::this_thread::sleep_for(duration);
+    is_running = false;
+
+    for (auto& thd : threads)
+        thd.join();
+
+    const double seconds = std::chrono::duration<double>(duration).count();
+
+    return ReadWriteRates{no_of_reads / seconds, no_of_writes / seconds};
+}
+
+bool demo_seqlock()
+{
+    const Cents initial_balance = 10'000'00;
+    const unsigned no_of_readers = std::max(2u, std::thread::hardware_concurrency() - 1);
+    const unsigned no_of_writers = 1;
+    const auto duration = std::chrono::milliseconds{300};
+
+    StdMutexBankAccount mutex_account(1, initial_balance);
+    SeqlockBankAccount seqlock_account(2, initial_balance);
+
+    const auto mutex_rates = benchmark_reads_writes(mutex_account, no_of_readers, no_of_writers, duration);
+    const auto seqlock_rates = benchmark_reads_writes(seqlock_account, no_of_readers, no_of_writers, duration);
+
+    const bool is_balance_preserved = mutex_account.balance() == initial_balance && seqlock_account.balance() == initial_balance;
+
+    std::cout << no_of_readers << " readers, " << no_of_writers << " writer - "
+              << "BankAccount: " << mutex_rates.reads_per_s << " reads/s, " << mutex_rates.writes_per_s << " writes/s; "
+              << "SeqlockBankAccount: " << seqlock_rates.reads_per_s << " reads/s, " << seqlock_rates.writes_per_s << " writes/s; balances "
+              << (is_balance_preserved ? "preserved" : "CORRUPTED") << std::endl;
+
+    return is_balance_preserved;
+}
+
+bool demo_snapshot()
+{
+    const size_t no_of_accounts = 100'000;
+    const Cents initial_balance = 100'00;
+    const Cents expected_total = initial_balance * static_cast<Cents>(no_of_accounts);
+    const unsigned no_of_threads = std::max(2u, std::thread::hardware_concurrency()) - 1;
+    const auto duration = std::chrono::milliseconds{500};
+
+    Ledger ledger(no_of_accounts, initial_balance);
+
+    std::atomic<bool> is_running{true};
+    std::atomic<uint64_t> no_of_transfers{0};
+
+    std::vector<std::thread> threads;
+    for (unsigned t = 0; t < no_of_threads; ++t)
+        threads.emplace_back([&, t] {
+            std::mt19937_64 rnd{t};
+            std::uniform_int_distribution<AccountId> account(0, no_of_accounts - 1);
+            std::uniform_int_distribution<Cents> amount(1, 50'00);
+
+            uint64_t count = 0;
+            while (is_running)
+            {
+                ledger.transfer(account(rnd), account(rnd), amount(rnd));
+                ++count;
+            }
+
+            no_of_transfers += count;
+        });
+
+    // the reader checks the invariant while the transfers continue
+    int no_of_snapshots = 0;
+    bool is_invariant = true;
+    const auto deadline = std::chrono::steady_clock::now() + duration;
+    while (std::chrono::steady_clock::now() < deadline)
+    {
+        is_invariant = is_invariant && ledger.snapshot_total() == expected_total;
+
+        const auto balances = ledger.snapshot();
+        is_invariant = is_invariant && std::accumulate(balances.begin(), balances.end(), Cents{0}) == expected_total
+            && std::all_of(balances.begin(), balances.end(), [](Cents b) { return b >= 0; });
+
+        no_of_snapshots += 2;
+    }
+
+    is_running = false;
+    for (auto& thd : threads)
+        thd.join();
+
+    std::cout << "Snapshots: " << no_of_snapshots << " snapshots during " << no_of_transfers / std::chrono::duration<double>(duration).count()
+              << " transfers/s on " << no_of_threads << " threads; total balance " << (is_invariant ? "invariant" : "VIOLATED") << std::endl;
+
+    return is_invariant;
+}
+
+// fan-out payout: the payer pays fee to each of the payees, all or nothing
+struct Payout
+{
+    static constexpr int no_of_payees = 3;
+    static constexpr Cents fee = 1'00;
+
+    AccountId payer;
+    AccountId payees[no_of_payees];
+};
+
+// no_of_threads threads make no_of_payouts payouts each among no_of_accounts accounts; returns payouts per second
+template <typename MakePayout>
+double benchmark_payouts(size_t no_of_accounts, unsigned no_of_threads, int no_of_payouts, MakePayout make_payout)
+{
+    auto start = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> threads;
+    for (unsigned t = 0; t < no_of_threads; ++t)
+        threads.emplace_back([=] {
+            std::mt19937_64 rnd{t};
+            std::uniform_int_distribution<AccountId> account(0, no_of_accounts - 1);
+
+            for (int i = 0; i < no_of_payouts; ++i)
+            {
+                // distinct accounts - std::lock must not lock one mutex twice
+                AccountId ids[1 + Payout::no_of_payees];
+                for (size_t k = 0; k < std::size(ids); ++k)
+                    do
+                        ids[k] = account(rnd);
+                    while (std::find(ids, ids + k, ids[k]) != ids + k);
+
+                make_payout(Payout{ids[0], {ids[1], ids[2], ids[3]}});
+            }
+        });
+
+    for (auto& thd : threads)
+        thd.join();
+
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    return no_of_threads * no_of_payouts / elapsed.count();
+}
+
+bool demo_stm()
+{
+    struct LockedAccount
+    {
+        std::mutex mtx;
+        Cents balance;
+    };
+
+    const int no_of_payouts = 200'000;
+    const Cents initial_balance = 1'000'000'00;
+    const unsigned no_of_threads = std::max(4u, std::thread::hardware_concurrency());
+
+    bool is_total_preserved = true;
+    for (size_t no_of_accounts : {8, 64, 100'000})
+    {
+        std::vector<LockedAccount> locked_accounts(no_of_accounts);
+        for (auto& a : locked_accounts)
+            a.balance = initial_balance;
+
+        const double lock_rate = benchmark_payouts(no_of_accounts, no_of_threads, no_of_payouts, [&](const Payout& p) {
+            LockedAccount& payer = locked_accounts[p.payer];
+            LockedAccount& payee1 = locked_accounts[p.payees[0]];
+            LockedAccount& payee2 = locked_accounts[p.payees[1]];
+            LockedAccount& payee3 = locked_accounts[p.payees[2]];
+
+            std::unique_lock<std::mutex> lk0{payer.mtx, std::defer_lock};
+            std::unique_lock<std::mutex> lk1{payee1.mtx, std::defer_lock};
+            std::unique_lock<std::mutex> lk2{payee2.mtx, std::defer_lock};
+            std::unique_lock<std::mutex> lk3{payee3.mtx, std::defer_lock};
+            std::lock(lk0, lk1, lk2, lk3);
+
+            if (payer.balance < Payout::no_of_payees * Payout::fee)
+                return;
+
+            payer.balance -= Payout::no_of_payees * Payout::fee;
+            payee1.balance += Payout::fee;
+            payee2.balance += Payout::fee;
+            payee3.balance += Payout::fee;
+        });
+
+        StmLedger ledger(no_of_accounts, initial_balance);
+        std::atomic<int> no_of_given_up{0};
+
+        const double stm_rate = benchmark_payouts(no_of_accounts, no_of_threads, no_of_payouts, [&](const Payout& p) {
+            try
+            {
+                ledger.atomically([&](StmLedger::Transaction& tx) {
+                    const Cents balance = tx.read(p.payer);
+                    if (balance < Payout::no_of_payees * Payout::fee)
+                        return false;
+
+                    tx.write(p.payer, balance - Payout::no_of_payees * Payout::fee);
+                    for (AccountId payee : p.payees)
+                        tx.write(payee, tx.read(payee) + Payout::fee);
+                    return true;
+                });
+            }
+            catch (const TransactionConflict&)
+            {
+                ++no_of_given_up; // moved no money - the total stays exact
+            }
+        });
+
+        Cents locked_total = 0;
+        for (auto& a : locked_accounts)
+            locked_total += a.balance;
+
+        Cents stm_total = 0;
+        for (AccountId id = 0; id < no_of_accounts; ++id)
+            stm_total += ledger.balance(id);
+
+        const Cents expected_total = initial_balance * static_cast<Cents>(no_of_accounts);
+        const bool is_preserved = locked_total == expected_total && stm_total == expected_total;
+        is_total_preserved = is_total_preserved && is_preserved;
+
+        std::cout << "Payouts among " << no_of_accounts << " accounts on " << no_of_threads << " threads - "
+                  << "std::lock: " << lock_rate << " payouts/s; STM: " << stm_rate << " payouts/s ("
+                  << ledger.no_of_conflicts() << " retries, " << no_of_given_up << " given up); total balance "
+                  << (is_preserved ? "preserved" : "CORRUPTED") << std::endl;
+    }
+
+    // zero and negative amounts must not move money
+    StmLedger small(2, initial_balance);
+    int no_of_rejected = 0;
+    for (Cents amount : {-50'00, 0})
+        try
+        {
+            small.transfer(0, 1, amount);
+        }
+        catch (const std::invalid_argument&)
+        {
+            ++no_of_rejected;
+        }
+
+    const bool is_rejected = no_of_rejected == 2 && small.balance(0) == initial_balance && small.balance(1) == initial_balance;
+
+    std::cout << "StmLedger: invalid amounts " << (is_rejected ? "rejected" : "ACCEPTED") << std::endl;
+
+    return is_total_preserved && is_rejected;
+}
+
+bool demo_transfer_batch()
+{
+    const size_t no_of_accounts = 1'000'000;
+    const Cents initial_balance = 10'00;
+    const size_t no_of_transfers = 1'000'000;
+
+    std::mt19937_64 rnd{42};
+    std::uniform_int_distribution<AccountId> account(0, no_of_accounts - 1);
+    std::uniform_int_distribution<Cents> amount(1, 20'00);
+
+    std::vector<Transfer> transfers;
+    transfers.reserve(no_of_transfers);
+    for (size_t i = 0; i < no_of_transfers; ++i)
+        transfers.push_back(Transfer{account(rnd), account(rnd), amount(rnd)});
+
+    Ledger one_by_one(no_of_accounts, initial_balance);
+    Ledger batched(no_of_accounts, initial_balance);
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<TransferStatus> expected;
+    expected.reserve(no_of_transfers);
+    for (const auto& t : transfers)
+        expected.push_back(one_by_one.transfer(t.from, t.to, t.amount));
+    const std::chrono::duration<double> one_by_one_time = std::chrono::steady_clock::now() - start;
+
+    start = std::chrono::steady_clock::now();
+    const auto results = batched.transfer_batch(transfers);
+    const std::chrono::duration<double> batch_time = std::chrono::steady_clock::now() - start;
+
+    bool same_balances = true;
+    for (AccountId id = 0; id < no_of_accounts; ++id)
+        same_balances = same_balances && one_by_one.balance(id) == batched.balance(id);
+
+    const bool is_identical = results == expected && same_balances;
+
+    std::cout << "Transfers one by one: " << no_of_transfers / one_by_one_time.count() << " transfers/s; "
+              << "transfer_batch: " << no_of_transfers / batch_time.count() << " transfers/s; "
+              << "results " << (is_identical ? "identical" : "DIFFERENT") << std::endl;
+
+    return is_identical;
+}
+
+int main(int argc, char* argv[])
+{
+    // every demo checks its results and returns false when they are wrong
+    const std::map<std::string, std::function<bool()>> demos = {
+        {"async_logger", demo_async_logger},
+        {"atomic_bank_account", demo_atomic_bank_account},
+        {"bank_account", demo_bank_account},
+        {"hot_account", demo_hot_account},
+        {"journal", demo_journal},
+        {"ledger", demo_ledger},
+        {"lock_order", demo_lock_order},
+        {"seqlock", demo_seqlock},
+        {"snapshot", demo_snapshot},
+        {"stm", demo_stm},
+        {"transfer_batch", demo_transfer_batch}};
+
+    if (argc >= 2 && demos.count(argv[1]) == 0)
+    {
+        std::cerr << "unknown demo: " << argv[1] << "; available:";
+        for (const auto& demo : demos)
+            std::cerr << " " << demo.first;
+        std::cerr << std::endl;
+
+        return 2;
+    }
+
+    // runs the demo given as the argument, or all of them; fails when any check fails
+    bool is_ok = true;
+    for (const auto& demo : demos)
+        if (argc < 2 || demo.first == argv[1])
+            is_ok = demo.second() && is_ok;
+
+    return is_ok ? 0 : 1;
 }
@@ -0,0 +1,297 @@
+#ifndef DEBUG_MUTEX_HPP
+#define DEBUG_MUTEX_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <iterator>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+struct LockStats
+{
+    std::string name;
+    uint64_t acquisitions = 0;
+    uint64_t contended = 0; // acquisitions that had to wait
+    std::chrono::nanoseconds total_wait{0};
+    std::chrono::nanoseconds total_hold{0};
+    std::chrono::nanoseconds max_hold{0};
+};
+
+class DebugMutex;
+
+// Global lock-order graph: an edge a -> b means that some thread blocked on b while holding a.
+// An acquisition that would close a cycle is a lock-order inversion - two threads taking the same
+// mutexes in these orders can deadlock - and is reported to the handler (std::cerr by default)
+// at the moment it happens, whether or not the threads actually deadlock.
+// Locking a mutex again by the thread holding it would deadlock for sure - lock() throws std::logic_error instead.
+class LockGraph
+{
+    friend class DebugMutex;
+
+    struct Node
+    {
+        const DebugMutex* mutex;
+        std::unordered_set<uint64_t> successors;
+    };
+
+    std::mutex mtx_;
+    std::unordered_map<uint64_t, Node> nodes_;
+    std::function<void(const std::string&)> handler_ = [](const std::string& report) { std::cerr << report << std::endl; };
+
+    LockGraph() = default;
+
+    // mutexes on a path from -> ... -> to (empty when there is none)
+    std::vector<uint64_t> find_path(uint64_t from, uint64_t to) const
+    {
+        std::vector<uint64_t> path{from};
+        std::unordered_set<uint64_t> visited{from};
+
+        std::function<bool(uint64_t)> visit = [&](uint64_t id) {
+            if (id == to)
+                return true;
+
+            auto node = nodes_.find(id);
+            if (node == nodes_.end())
+                return false;
+
+            for (uint64_t next : node->second.successors)
+                if (visited.insert(next).second)
+                {
+                    path.push_back(next);
+                    if (visit(next))
+                        return true;
+                    path.pop_back();
+                }
+
+            return false;
+        };
+
+        return visit(from) ? path : std::vector<uint64_t>{};
+    }
+
+    void add(const DebugMutex& mutex, uint64_t id);
+    void remove(uint64_t id);
+    void before_blocking_lock(const DebugMutex& mutex, uint64_t id, const std::vector<uint64_t>& held);
+    void report(const std::string& message);
+
+public:
+    static LockGraph& instance()
+    {
+        static LockGraph graph;
+        return graph;
+    }
+
+    void set_handler(std::function<void(const std::string&)> handler)
+    {
+        std::lock_guard<std::mutex> lk{mtx_};
+        handler_ = std::move(handler);
+    }
+
+    // statistics of all existing DebugMutex-es
+    std::vector<LockStats> stats();
+};
+
+// Drop-in replacement for std::mutex (Lockable, so it works with lock_guard, unique_lock and std::lock)
+// that feeds the LockGraph and collects wait/hold times. Blocking lock() calls record the lock order;
+// try_lock() never blocks, so it cannot take part in a deadlock and records nothing.
+// Much slower than std::mutex - meant for tests and debugging sessions, not for code that is measured.
+class DebugMutex
+{
+    using Clock = std::chrono::steady_clock;
+
+    struct Held
+    {
+        DebugMutex* mutex;
+        Clock::time_point acquired_at;
+    };
+
+    static inline thread_local std::vector<Held> held_; // by the current thread, in acquisition order
+
+    static uint64_t next_id()
+    {
+        static std::atomic<uint64_t> next{1};
+        return next++;
+    }
+
+    std::mutex mtx_;
+    const uint64_t id_;
+    const std::string name_;
+
+    std::atomic<uint64_t> acquisitions_{0};
+    std::atomic<uint64_t> contended_{0};
+    std::atomic<int64_t> total_wait_ns_{0};
+    std::atomic<int64_t> total_hold_ns_{0};
+    std::atomic<int64_t> max_hold_ns_{0};
+
+    void acquired()
+    {
+        acquisitions_.fetch_add(1, std::memory_order_relaxed);
+        held_.push_back(Held{this, Clock::now()});
+    }
+
+public:
+    explicit DebugMutex(std::string name = "")
+        : id_{next_id()}
+        , name_{name.empty() ? "mutex#" + std::to_string(id_) : std::move(name)}
+    {
+        LockGraph::instance().add(*this, id_);
+    }
+
+    DebugMutex(const DebugMutex&) = delete;
+    DebugMutex& operator=(const DebugMutex&) = delete;
+
+    ~DebugMutex()
+    {
+        LockGraph::instance().remove(id_);
+    }
+
+    // throws std::logic_error when the calling thread already holds the mutex
+    void lock()
+    {
+        std::vector<uint64_t> held;
+        for (const auto& h : held_)
+            held.push_back(h.mutex->id_);
+
+        if (!held.empty())
+            LockGraph::instance().before_blocking_lock(*this, id_, held);
+
+        if (!mtx_.try_lock())
+        {
+            contended_.fetch_add(1, std::memory_order_relaxed);
+
+            const auto start = Clock::now();
+            mtx_.lock();
+            total_wait_ns_.fetch_add(std::chrono::nanoseconds(Clock::now() - start).count(), std::memory_order_relaxed);
+        }
+
+        acquired();
+    }
+
+    bool try_lock()
+    {
+        if (!mtx_.try_lock())
+            return false;
+
+        acquired();
+        return true;
+    }
+
+    void unlock()
+    {
+        auto it = std::find_if(held_.rbegin(), held_.rend(), [this](const Held& h) { return h.mutex == this; });
+        if (it != held_.rend())
+        {
+            const int64_t hold_ns = std::chrono::nanoseconds(Clock::now() - it->acquired_at).count();
+            total_hold_ns_.fetch_add(hold_ns, std::memory_order_relaxed);
+            if (hold_ns > max_hold_ns_.load(std::memory_order_relaxed))
+                max_hold_ns_.store(hold_ns, std::memory_order_relaxed); // only the holder writes it
+
+            held_.erase(std::next(it).base());
+        }
+
+        mtx_.unlock();
+    }
+
+    const std::string& name() const
+    {
+        return name_;
+    }
+
+    LockStats stats() const
+    {
+        LockStats s;
+        s.name = name_;
+        s.acquisitions = acquisitions_.load(std::memory_order_relaxed);
+        s.contended = contended_.load(std::memory_order_relaxed);
+        s.total_wait = std::chrono::nanoseconds{total_wait_ns_.load(std::memory_order_relaxed)};
+        s.total_hold = std::chrono::nanoseconds{total_hold_ns_.load(std::memory_order_relaxed)};
+        s.max_hold = std::chrono::nanoseconds{max_hold_ns_.load(std::memory_order_relaxed)};
+        return s;
+    }
+};
+
+inline void LockGraph::add(const DebugMutex& mutex, uint64_t id)
+{
+    std::lock_guard<std::mutex> lk{mtx_};
+    nodes_.emplace(id, Node{&mutex, {}});
+}
+
+inline void LockGraph::remove(uint64_t id)
+{
+    std::lock_guard<std::mutex> lk{mtx_};
+    nodes_.erase(id);
+    for (auto& node : nodes_)
+        node.second.successors.erase(id);
+}
+
+inline void LockGraph::before_blocking_lock(const DebugMutex& mutex, uint64_t id, const std::vector<uint64_t>& held)
+{
+    if (std::find(held.begin(), held.end(), id) != held.end())
+        throw std::logic_error("lock order violation: " + mutex.name() + " locked again by the thread holding it (self-deadlock)");
+
+    std::string message;
+    {
+        std::lock_guard<std::mutex> lk{mtx_};
+
+        for (uint64_t held_id : held)
+        {
+            if (nodes_[held_id].successors.count(id) != 0)
+                continue; // known order
+
+            // the new edge held -> mutex closes a cycle if mutex already leads to held
+            const auto path = find_path(id, held_id);
+            if (!path.empty() && message.empty())
+            {
+                message = "lock order inversion: " + mutex.name() + " locked while holding " + nodes_[held_id].mutex->name()
+                    + ", but earlier";
+                for (size_t i = 0; i < path.size(); ++i)
+                    message += (i == 0 ? " " : " -> ") + nodes_[path[i]].mutex->name();
+                message += " - potential deadlock";
+            }
+
+            nodes_[held_id].successors.insert(id); // every inversion is reported once
+        }
+    }
+
+    if (!message.empty())
+        report(message);
+}
+
+inline void LockGraph::report(const std::string& message)
+{
+    std::function<void(const std::string&)> handler;
+    {
+        std::lock_guard<std::mutex> lk{mtx_};
+        handler = handler_;
+    }
+
+    handler(message);
+}
+
+inline std::vector<LockStats> LockGraph::stats()
+{
+    std::lock_guard<std::mutex> lk{mtx_};
+
+    std::vector<LockStats> result;
+    for (const auto& node : nodes_)
+        result.push_back(node.second.mutex->stats());
+
+    return result;
+}
+
+// lock-order checking in debug builds, a plain std::mutex in release (NDEBUG) builds
+#ifndef NDEBUG
+using DefaultMutex = DebugMutex;
+#else
+using DefaultMutex = std::mutex;
+#endif
+
+#endif // DEBUG_MUTEX_HPP
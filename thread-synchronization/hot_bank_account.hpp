@@ -0,0 +1,143 @@
+#ifndef HOT_BANK_ACCOUNT_HPP
+#define HOT_BANK_ACCOUNT_HPP
+
+#include <cstddef>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "concurrency_utils.hpp"
+#include "money.hpp"
+
+// Account for hot spots (fee collectors, clearing accounts) that receive deposits from many threads at once.
+// The balance is split into slices, each with its own mutex on its own cache line, and every thread works
+// on the slice assigned to it, so deposits from different threads do not contend.
+// withdraw() takes the amount from the thread's own slice; only when that slice runs dry it locks all slices
+// and spreads the remaining balance evenly across them. balance() locks all slices and sums them.
+class HotBankAccount
+{
+    static constexpr size_t cache_line_size = 64;
+
+    struct alignas(cache_line_size) Slice
+    {
+        std::mutex mtx;
+        Cents balance = 0;
+    };
+
+    const int id_;
+    const size_t no_of_slices_;
+    std::unique_ptr<Slice[]> slices_;
+
+    Slice& own_slice()
+    {
+        return slices_[thread_token() % no_of_slices_];
+    }
+
+    // in slice order - cannot deadlock with another rebalance or balance()
+    std::vector<std::unique_lock<std::mutex>> lock_all() const
+    {
+        std::vector<std::unique_lock<std::mutex>> locks;
+        locks.reserve(no_of_slices_);
+        for (size_t i = 0; i < no_of_slices_; ++i)
+            locks.emplace_back(slices_[i].mtx);
+
+        return locks;
+    }
+
+    bool rebalance_and_withdraw(Slice& own, Cents amount)
+    {
+        auto locks = lock_all();
+
+        Cents total = 0;
+        for (size_t i = 0; i < no_of_slices_; ++i)
+            total += slices_[i].balance;
+
+        if (total < amount)
+            return false;
+
+        total -= amount;
+
+        const Cents share = total / static_cast<Cents>(no_of_slices_);
+        for (size_t i = 0; i < no_of_slices_; ++i)
+            slices_[i].balance = share;
+        own.balance += total - share * static_cast<Cents>(no_of_slices_);
+
+        return true;
+    }
+
+public:
+    HotBankAccount(int id, Cents balance, size_t no_of_slices = std::thread::hardware_concurrency())
+        : id_(id)
+        , no_of_slices_{no_of_slices > 0 ? no_of_slices : 1}
+        , slices_{new Slice[no_of_slices_]}
+    {
+        slices_[0].balance = balance;
+    }
+
+    HotBankAccount(const HotBankAccount&) = delete;
+    HotBankAccount& operator=(const HotBankAccount&) = delete;
+
+    void print() const
+    {
+        std::cout << "Bank Account #" << id() << "; Balance = " << balance() << std::endl;
+    }
+
+    // Withdraws from this account first and only then deposits to the other one (like AtomicBankAccount),
+    // so the two accounts are never locked together.
+    bool transfer(HotBankAccount& to, Cents amount)
+    {
+        if (!withdraw(amount))
+            return false;
+
+        to.deposit(amount);
+        return true;
+    }
+
+    // returns false (and leaves the balance unchanged) when the balance is lower than amount
+    bool withdraw(Cents amount)
+    {
+        Slice& own = own_slice();
+        {
+            std::lock_guard<std::mutex> lk{own.mtx};
+            if (own.balance >= amount)
+            {
+                own.balance -= amount;
+                return true;
+            }
+        }
+
+        return rebalance_and_withdraw(own, amount);
+    }
+
+    void deposit(Cents amount)
+    {
+        Slice& own = own_slice();
+        std::lock_guard<std::mutex> lk{own.mtx};
+        own.balance += amount;
+    }
+
+    int id() const
+    {
+        return id_;
+    }
+
+    Cents balance() const
+    {
+        auto locks = lock_all();
+
+        Cents total = 0;
+        for (size_t i = 0; i < no_of_slices_; ++i)
+            total += slices_[i].balance;
+
+        return total;
+    }
+
+    size_t no_of_slices() const
+    {
+        return no_of_slices_;
+    }
+};
+
+#endif // HOT_BANK_ACCOUNT_HPP
@@ -0,0 +1,341 @@
+#ifndef JOURNAL_HPP
+#define JOURNAL_HPP
+
+#include <atomic>
+#include <cerrno>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <thread>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+enum class JournalOp : uint32_t
+{
+    open_account,
+    deposit,
+    withdraw,
+    transfer
+};
+
+// Fixed-size journal entry. Fields are written first and state last (release), so a record
+// with state == complete is fully written - also after a crash, once it has been synced.
+struct JournalRecord
+{
+    static constexpr uint32_t empty = 0;
+    static constexpr uint32_t complete = 0x4A524E4C;
+
+    std::atomic<uint32_t> state;
+    JournalOp op;
+    uint64_t sequence;
+    int32_t account;
+    int32_t other_account; // transfer target
+    double amount;
+};
+
+static_assert(sizeof(JournalRecord) == 32, "JournalRecord must have a fixed on-disk size");
+static_assert(std::atomic<uint32_t>::is_always_lock_free, "JournalRecord::state must be lock-free to live in a mapped file");
+
+// Append-only binary journal in a memory-mapped file of fixed capacity.
+// append() reserves a slot with a single fetch_add and writes the record into the mapping without locking;
+// commit() makes it durable with group commit: one waiting thread becomes the leader and syncs every
+// record written so far with a single msync, while the others wait for it and are usually done too.
+// Opening an existing file continues after its last complete record.
+class Journal
+{
+    struct Header
+    {
+        uint64_t magic;
+        uint32_t version;
+        uint32_t record_size;
+        uint64_t capacity;
+        char reserved[40];
+    };
+
+    static constexpr uint64_t magic = 0x004C414E52554F4A; // "JOURNAL" read as little-endian
+    static constexpr uint32_t version = 1;
+
+    int fd_ = -1;
+    size_t file_size_ = 0;
+    void* mapping_ = nullptr;
+    Header* header_ = nullptr;
+    JournalRecord* records_ = nullptr;
+    uint64_t capacity_ = 0;
+
+    std::atomic<uint64_t> next_{0}; // next free slot
+
+    std::mutex commit_mtx_;
+    std::condition_variable commit_cv_;
+    uint64_t durable_ = 0; // records [0, durable_) are synced to disk
+    bool is_flushing_ = false;
+    std::atomic<uint64_t> no_of_syncs_{0};
+
+    [[noreturn]] static void throw_errno(const char* what)
+    {
+        throw std::system_error(errno, std::generic_category(), what);
+    }
+
+    static size_t page_size()
+    {
+        static const size_t size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        return size;
+    }
+
+    // first slot at or after begin that is not a complete record
+    uint64_t complete_end_(uint64_t begin) const
+    {
+        uint64_t end = begin;
+        while (end < capacity_ && records_[end].state.load(std::memory_order_acquire) == JournalRecord::complete
+            && records_[end].sequence == end)
+            ++end;
+
+        return end;
+    }
+
+    void sync_(uint64_t begin, uint64_t end)
+    {
+        const size_t first = reinterpret_cast<char*>(&records_[begin]) - static_cast<char*>(mapping_);
+        const size_t last = reinterpret_cast<char*>(&records_[end]) - static_cast<char*>(mapping_);
+        const size_t aligned_first = first / page_size() * page_size();
+
+        if (msync(static_cast<char*>(mapping_) + aligned_first, last - aligned_first, MS_SYNC) != 0)
+            throw_errno("msync");
+
+        ++no_of_syncs_;
+    }
+
+    void open_(const std::string& path, uint64_t capacity)
+    {
+        fd_ = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+        if (fd_ < 0)
+            throw_errno("open");
+
+        struct stat st;
+        if (fstat(fd_, &st) != 0)
+            throw_errno("fstat");
+
+        Header existing{};
+        const bool is_new = st.st_size == 0;
+        if (!is_new)
+        {
+            if (pread(fd_, &existing, sizeof(existing), 0) != static_cast<ssize_t>(sizeof(existing))
+                || existing.magic != magic || existing.version != version || existing.record_size != sizeof(JournalRecord))
+                throw std::runtime_error("not a journal file: " + path);
+
+            capacity = existing.capacity;
+        }
+
+        capacity_ = capacity;
+        file_size_ = sizeof(Header) + capacity_ * sizeof(JournalRecord);
+
+        if (is_new)
+        {
+            if (ftruncate(fd_, static_cast<off_t>(file_size_)) != 0)
+                throw_errno("ftruncate");
+        }
+        else if (static_cast<size_t>(st.st_size) < file_size_)
+            throw std::runtime_error("truncated journal file: " + path);
+
+        mapping_ = mmap(nullptr, file_size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+        if (mapping_ == MAP_FAILED)
+        {
+            mapping_ = nullptr;
+            throw_errno("mmap");
+        }
+
+        header_ = static_cast<Header*>(mapping_);
+        records_ = reinterpret_cast<JournalRecord*>(static_cast<char*>(mapping_) + sizeof(Header));
+
+        if (is_new)
+        {
+            header_->magic = magic;
+            header_->version = version;
+            header_->record_size = sizeof(JournalRecord);
+            header_->capacity = capacity_;
+
+            if (msync(mapping_, page_size(), MS_SYNC) != 0 || fsync(fd_) != 0)
+                throw_errno("fsync");
+        }
+
+        // records after a gap were never acknowledged by commit() - forget them,
+        // so that they do not reappear once the gap gets filled by new appends
+        const uint64_t end = complete_end_(0);
+        bool has_stale_records = false;
+        for (uint64_t i = end; i < capacity_; ++i)
+            if (records_[i].state.load(std::memory_order_relaxed) != JournalRecord::empty)
+            {
+                records_[i].state.store(JournalRecord::empty, std::memory_order_relaxed);
+                has_stale_records = true;
+            }
+
+        if (has_stale_records)
+            sync_(end, capacity_);
+
+        next_ = end;
+        durable_ = end;
+    }
+
+    void close_()
+    {
+        if (mapping_)
+            munmap(mapping_, file_size_);
+        if (fd_ >= 0)
+            ::close(fd_);
+    }
+
+public:
+    // capacity (in records) is used only when the file is created
+    explicit Journal(const std::string& path, uint64_t capacity = 1 << 20)
+    {
+        try
+        {
+            open_(path, capacity);
+        }
+        catch (...)
+        {
+            close_();
+            throw;
+        }
+    }
+
+    Journal(const Journal&) = delete;
+    Journal& operator=(const Journal&) = delete;
+
+    ~Journal()
+    {
+        {
+            std::unique_lock<std::mutex> lk{commit_mtx_};
+            commit_cv_.wait(lk, [this] { return !is_flushing_; });
+        }
+
+        const uint64_t end = complete_end_(durable_);
+        if (end > durable_)
+            msync(mapping_, file_size_, MS_SYNC);
+
+        close_();
+    }
+
+    // writes the record to the mapping (not yet durable) and returns its sequence number;
+    // throws std::length_error when the journal is full
+    uint64_t append(JournalOp op, int32_t account, int32_t other_account, double amount)
+    {
+        const uint64_t sequence = next_.fetch_add(1, std::memory_order_relaxed);
+        if (sequence >= capacity_)
+            throw std::length_error("journal is full");
+
+        JournalRecord& record = records_[sequence];
+        record.op = op;
+        record.sequence = sequence;
+        record.account = account;
+        record.other_account = other_account;
+        record.amount = amount;
+        record.state.store(JournalRecord::complete, std::memory_order_release);
+
+        return sequence;
+    }
+
+    // blocks until the record (and every record before it) is synced to disk
+    void commit(uint64_t sequence)
+    {
+        std::unique_lock<std::mutex> lk{commit_mtx_};
+
+        while (durable_ <= sequence)
+        {
+            if (is_flushing_)
+            {
+                commit_cv_.wait(lk);
+                continue;
+            }
+
+            // become the leader: sync everything appended so far in one go
+            is_flushing_ = true;
+            const uint64_t begin = durable_;
+            lk.unlock();
+
+            const uint64_t end = complete_end_(begin);
+            try
+            {
+                if (end > begin)
+                    sync_(begin, end);
+                else
+                    std::this_thread::yield(); // an earlier record is still being written
+            }
+            catch (...)
+            {
+                lk.lock();
+                is_flushing_ = false;
+                commit_cv_.notify_all();
+                throw;
+            }
+
+            lk.lock();
+            durable_ = end;
+            is_flushing_ = false;
+            commit_cv_.notify_all();
+        }
+    }
+
+    uint64_t capacity() const
+    {
+        return capacity_;
+    }
+
+    // number of records appended so far
+    uint64_t size() const
+    {
+        const uint64_t next = next_.load(std::memory_order_relaxed);
+        return next < capacity_ ? next : capacity_;
+    }
+
+    // number of msync calls made by commit()
+    uint64_t no_of_syncs() const
+    {
+        return no_of_syncs_;
+    }
+
+    // calls f(const JournalRecord&) for every complete record in sequence order
+    template <typename F>
+    void replay(F f) const
+    {
+        const uint64_t end = complete_end_(0);
+        for (uint64_t i = 0; i < end; ++i)
+            f(records_[i]);
+    }
+};
+
+// rebuilds account balances (account id -> balance) from the journal
+inline std::map<int32_t, double> replay_balances(const Journal& journal)
+{
+    std::map<int32_t, double> balances;
+
+    journal.replay([&balances](const JournalRecord& record) {
+        switch (record.op)
+        {
+        case JournalOp::open_account:
+            balances[record.account] = record.amount;
+            break;
+        case JournalOp::deposit:
+            balances[record.account] += record.amount;
+            break;
+        case JournalOp::withdraw:
+            balances[record.account] -= record.amount;
+            break;
+        case JournalOp::transfer:
+            balances[record.account] -= record.amount;
+            balances[record.other_account] += record.amount;
+            break;
+        }
+    });
+
+    return balances;
+}
+
+#endif // JOURNAL_HPP
@@ -0,0 +1,377 @@
+#ifndef LEDGER_HPP
+#define LEDGER_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "money.hpp"
+
+using AccountId = size_t;
+
+enum class TransferStatus
+{
+    ok,
+    insufficient_funds
+};
+
+struct Transfer
+{
+    AccountId from;
+    AccountId to;
+    Cents amount;
+};
+
+// Reusable barrier for a fixed number of threads (std::barrier is C++20)
+class Barrier
+{
+    const size_t count_;
+    size_t waiting_ = 0;
+    size_t generation_ = 0;
+    std::mutex mtx_;
+    std::condition_variable cv_;
+
+public:
+    explicit Barrier(size_t count)
+        : count_{count}
+    {
+    }
+
+    void arrive_and_wait()
+    {
+        std::unique_lock<std::mutex> lk{mtx_};
+        const size_t generation = generation_;
+
+        if (++waiting_ == count_)
+        {
+            waiting_ = 0;
+            ++generation_;
+            cv_.notify_all();
+        }
+        else
+            cv_.wait(lk, [&] { return generation_ != generation; });
+    }
+};
+
+// Account table for many accounts: balances live in one contiguous array indexed by account id,
+// guarded by a fixed set of striped mutexes (account id % no_of_stripes) instead of a mutex per account.
+// transfer() locks the two stripes in stripe order, so it cannot deadlock with any other operation.
+//
+// snapshot()/snapshot_total() read a consistent state of all accounts without stopping the writers
+// (epoch-based copy-on-write): the reader starts a new epoch, and while it is reading, the first change
+// of an account in that epoch saves its previous balance first, so the reader sees the balance as of the epoch start.
+// When no snapshot is in progress, writers pay only for one relaxed load of the epoch.
+class Ledger
+{
+    static constexpr size_t cache_line_size = 64;
+
+    struct alignas(cache_line_size) Stripe
+    {
+        std::mutex mtx;
+    };
+
+    // balance of an account before its first change in epoch
+    struct SavedBalance
+    {
+        std::atomic<Cents> balance{0};
+        std::atomic<uint64_t> epoch{0};
+    };
+
+    const size_t no_of_accounts_;
+    std::unique_ptr<std::atomic<Cents>[]> balances_; // changed only under the stripe lock; atomic for snapshot readers
+    std::unique_ptr<SavedBalance[]> saved_;
+    const size_t no_of_stripes_;
+    std::unique_ptr<Stripe[]> stripes_;
+
+    mutable std::atomic<uint64_t> epoch_{0}; // odd while a snapshot is in progress
+    mutable std::mutex snapshot_mtx_; // one snapshot at a time
+
+    void check_id(AccountId id) const
+    {
+        if (id >= no_of_accounts_)
+            throw std::out_of_range("invalid account id");
+    }
+
+    std::mutex& stripe_mtx(AccountId id) const
+    {
+        return stripes_[id % no_of_stripes_].mtx;
+    }
+
+    std::vector<std::unique_lock<std::mutex>> lock_all() const
+    {
+        std::vector<std::unique_lock<std::mutex>> locks;
+        locks.reserve(no_of_stripes_);
+        for (size_t i = 0; i < no_of_stripes_; ++i)
+            locks.emplace_back(stripes_[i].mtx);
+
+        return locks;
+    }
+
+    // read by writers once per operation with the stripe lock(s) held - a snapshot waits for every
+    // stripe after starting an epoch, so an operation is entirely before or entirely after its start
+    uint64_t current_epoch() const
+    {
+        return epoch_.load(std::memory_order_relaxed);
+    }
+
+    Cents get(AccountId id) const
+    {
+        return balances_[id].load(std::memory_order_relaxed);
+    }
+
+    // called under the stripe lock; saves the balance before its first change in a snapshot's epoch
+    void add(AccountId id, Cents amount, uint64_t epoch)
+    {
+        const Cents balance = get(id);
+
+        if (epoch % 2 == 1 && saved_[id].epoch.load(std::memory_order_relaxed) != epoch)
+        {
+            saved_[id].balance.store(balance, std::memory_order_relaxed);
+            saved_[id].epoch.store(epoch, std::memory_order_release);
+        }
+
+        balances_[id].store(balance + amount, std::memory_order_release);
+    }
+
+    TransferStatus apply(const Transfer& t, uint64_t epoch)
+    {
+        if (get(t.from) < t.amount)
+            return TransferStatus::insufficient_funds;
+
+        add(t.from, -t.amount, epoch);
+        add(t.to, t.amount, epoch);
+
+        return TransferStatus::ok;
+    }
+
+    // balance of the account at the start of the snapshot's epoch
+    Cents snapshot_balance(AccountId id, uint64_t epoch) const
+    {
+        if (saved_[id].epoch.load(std::memory_order_acquire) == epoch)
+            return saved_[id].balance.load(std::memory_order_relaxed);
+
+        const Cents balance = balances_[id].load(std::memory_order_acquire);
+
+        // a writer may have saved the old balance and changed it in the meantime
+        if (saved_[id].epoch.load(std::memory_order_acquire) == epoch)
+            return saved_[id].balance.load(std::memory_order_relaxed);
+
+        return balance;
+    }
+
+    // calls f(id, balance) for every account with balances from one consistent state
+    template <typename F>
+    void read_snapshot(F f) const
+    {
+        std::lock_guard<std::mutex> lk{snapshot_mtx_};
+
+        const uint64_t epoch = epoch_.load(std::memory_order_relaxed) + 1;
+        epoch_.store(epoch);
+
+        // operations that have read the previous epoch hold a stripe lock - wait for them to finish
+        for (size_t i = 0; i < no_of_stripes_; ++i)
+        {
+            stripes_[i].mtx.lock();
+            stripes_[i].mtx.unlock();
+        }
+
+        for (AccountId id = 0; id < no_of_accounts_; ++id)
+            f(id, snapshot_balance(id, epoch));
+
+        epoch_.store(epoch + 1);
+    }
+
+public:
+    Ledger(size_t no_of_accounts, Cents initial_balance, size_t no_of_stripes = 1024)
+        : no_of_accounts_{no_of_accounts}
+        , balances_{new std::atomic<Cents>[no_of_accounts]}
+        , saved_{new SavedBalance[no_of_accounts]}
+        , no_of_stripes_{no_of_stripes > 0 ? no_of_stripes : 1}
+        , stripes_{new Stripe[no_of_stripes_]}
+    {
+        for (size_t i = 0; i < no_of_accounts_; ++i)
+            balances_[i].store(initial_balance, std::memory_order_relaxed);
+    }
+
+    Ledger(const Ledger&) = delete;
+    Ledger& operator=(const Ledger&) = delete;
+
+    size_t size() const
+    {
+        return no_of_accounts_;
+    }
+
+    Cents balance(AccountId id) const
+    {
+        check_id(id);
+        std::lock_guard<std::mutex> lk{stripe_mtx(id)};
+        return get(id);
+    }
+
+    // deposit(), withdraw(), transfer() and transfer_batch() throw std::invalid_argument for an amount <= 0
+    void deposit(AccountId id, Cents amount)
+    {
+        check_id(id);
+        check_amount(amount);
+        std::lock_guard<std::mutex> lk{stripe_mtx(id)};
+        add(id, amount, current_epoch());
+    }
+
+    // returns false (and leaves the balance unchanged) when the balance is lower than amount
+    bool withdraw(AccountId id, Cents amount)
+    {
+        check_id(id);
+        check_amount(amount);
+        std::lock_guard<std::mutex> lk{stripe_mtx(id)};
+        if (get(id) < amount)
+            return false;
+
+        add(id, -amount, current_epoch());
+        return true;
+    }
+
+    TransferStatus transfer(AccountId from, AccountId to, Cents amount)
+    {
+        check_id(from);
+        check_id(to);
+        check_amount(amount);
+
+        const size_t first = std::min(from % no_of_stripes_, to % no_of_stripes_);
+        const size_t second = std::max(from % no_of_stripes_, to % no_of_stripes_);
+
+        std::lock_guard<std::mutex> lk_first{stripes_[first].mtx};
+        std::unique_lock<std::mutex> lk_second{stripes_[second].mtx, std::defer_lock};
+        if (second != first)
+            lk_second.lock();
+
+        return apply(Transfer{from, to, amount}, current_epoch());
+    }
+
+    // Executes the transfers as if one after another (in order) and returns their statuses.
+    // The batch is split into levels: a transfer goes one level after the last earlier transfer
+    // touching either of its accounts, so transfers within a level share no account and run in parallel
+    // without any per-transfer locking. All stripes are locked once for the whole batch.
+    // An invalid account id or amount in any transfer rejects the whole batch before anything is executed.
+    std::vector<TransferStatus> transfer_batch(const std::vector<Transfer>& transfers,
+        size_t no_of_threads = std::thread::hardware_concurrency())
+    {
+        for (const auto& t : transfers)
+        {
+            check_id(t.from);
+            check_id(t.to);
+            check_amount(t.amount);
+        }
+
+        // level of every transfer and transfer indexes ordered by level (counting sort)
+        std::vector<size_t> level(transfers.size());
+        size_t no_of_levels = 0;
+
+        auto assign_levels = [&](auto& next_level) {
+            for (size_t i = 0; i < transfers.size(); ++i)
+            {
+                auto& from_level = next_level[transfers[i].from];
+                auto& to_level = next_level[transfers[i].to];
+                level[i] = std::max<size_t>(from_level, to_level);
+                from_level = to_level = level[i] + 1;
+                no_of_levels = std::max(no_of_levels, level[i] + 1);
+            }
+        };
+
+        // a table indexed by account id is much faster than a hash map unless the batch is small
+        if (transfers.size() >= no_of_accounts_ / 16)
+        {
+            std::vector<size_t> next_level(no_of_accounts_);
+            assign_levels(next_level);
+        }
+        else
+        {
+            std::unordered_map<AccountId, size_t> next_level;
+            next_level.reserve(2 * transfers.size());
+            assign_levels(next_level);
+        }
+
+        std::vector<size_t> level_begin(no_of_levels + 1, 0);
+        for (auto l : level)
+            ++level_begin[l + 1];
+        for (size_t l = 0; l < no_of_levels; ++l)
+            level_begin[l + 1] += level_begin[l];
+
+        std::vector<size_t> order(transfers.size());
+        std::vector<size_t> fill(level_begin.begin(), level_begin.end() - 1);
+        for (size_t i = 0; i < transfers.size(); ++i)
+            order[fill[level[i]]++] = i;
+
+        std::vector<TransferStatus> results(transfers.size());
+
+        no_of_threads = std::max<size_t>(1, std::min(no_of_threads, transfers.size() / 1024));
+        Barrier barrier{no_of_threads};
+
+        auto locks = lock_all();
+        const uint64_t epoch = current_epoch();
+
+        auto worker = [&](size_t worker_id) {
+            for (size_t l = 0; l < no_of_levels; ++l)
+            {
+                const size_t begin = level_begin[l];
+                const size_t end = level_begin[l + 1];
+                const size_t chunk = (end - begin + no_of_threads - 1) / no_of_threads;
+
+                for (size_t i = begin + worker_id * chunk; i < std::min(end, begin + (worker_id + 1) * chunk); ++i)
+                    results[order[i]] = apply(transfers[order[i]], epoch);
+
+                barrier.arrive_and_wait();
+            }
+        };
+
+        std::vector<std::thread> helpers;
+        for (size_t w = 1; w < no_of_threads; ++w)
+            helpers.emplace_back(worker, w);
+
+        worker(0);
+
+        for (auto& thd : helpers)
+            thd.join();
+
+        return results;
+    }
+
+    // locks all stripes (in order) - stops every other operation for the duration of the sum
+    Cents total_balance() const
+    {
+        auto locks = lock_all();
+
+        Cents total = 0;
+        for (AccountId id = 0; id < no_of_accounts_; ++id)
+            total += get(id);
+
+        return total;
+    }
+
+    // consistent copy of all balances, taken while the other operations continue
+    std::vector<Cents> snapshot() const
+    {
+        std::vector<Cents> balances(no_of_accounts_);
+        read_snapshot([&balances](AccountId id, Cents balance) { balances[id] = balance; });
+
+        return balances;
+    }
+
+    // sum of all balances from one consistent state, computed while the other operations continue
+    Cents snapshot_total() const
+    {
+        Cents total = 0;
+        read_snapshot([&total](AccountId, Cents balance) { total += balance; });
+
+        return total;
+    }
+};
+
+#endif // LEDGER_HPP
@@ -0,0 +1,16 @@
+#ifndef MONEY_HPP
+#define MONEY_HPP
+
+#include <cstdint>
+#include <stdexcept>
+
+using Cents = int64_t; // balances and amounts in minor units
+
+// a negative amount would turn a withdraw into an unchecked deposit and a transfer into an unchecked debit
+inline void check_amount(Cents amount)
+{
+    if (amount <= 0)
+        throw std::invalid_argument("amount must be positive");
+}
+
+#endif // MONEY_HPP
@@ -0,0 +1,123 @@
+#ifndef SEQLOCK_BANK_ACCOUNT_HPP
+#define SEQLOCK_BANK_ACCOUNT_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <mutex>
+#include <thread>
+
+#include "money.hpp"
+
+struct AccountState
+{
+    Cents balance;
+    uint64_t no_of_operations;
+};
+
+// Account for read-mostly use (dashboards polling balances): writers serialize on a mutex
+// and bump a sequence number around every change (odd while the change is in progress);
+// readers never lock - they read the state optimistically and retry when the sequence number
+// shows that a writer was active in the meantime. Readers never block or slow down writers.
+class SeqlockBankAccount
+{
+    static constexpr size_t cache_line_size = 64;
+
+    const int id_;
+    std::mutex write_mtx_;
+
+    alignas(cache_line_size) std::atomic<uint64_t> sequence_{0};
+    std::atomic<Cents> balance_;
+    std::atomic<uint64_t> no_of_operations_{0};
+
+    // called with write_mtx_ locked
+    void begin_write()
+    {
+        sequence_.store(sequence_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+    }
+
+    void end_write()
+    {
+        sequence_.store(sequence_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    void add(Cents amount)
+    {
+        begin_write();
+        balance_.store(balance_.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+        no_of_operations_.store(no_of_operations_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        end_write();
+    }
+
+public:
+    SeqlockBankAccount(int id, Cents balance)
+        : id_(id)
+        , balance_(balance)
+    {
+    }
+
+    SeqlockBankAccount(const SeqlockBankAccount&) = delete;
+    SeqlockBankAccount& operator=(const SeqlockBankAccount&) = delete;
+
+    void print() const
+    {
+        const AccountState s = state();
+        std::cout << "Bank Account #" << id() << "; Balance = " << s.balance << "; Operations = " << s.no_of_operations << std::endl;
+    }
+
+    void transfer(SeqlockBankAccount& to, Cents amount)
+    {
+        std::unique_lock<std::mutex> lk_from{write_mtx_, std::defer_lock};
+        std::unique_lock<std::mutex> lk_to{to.write_mtx_, std::defer_lock};
+        std::lock(lk_from, lk_to); // deadlock free code
+
+        add(-amount);
+        to.add(amount);
+    }
+
+    void withdraw(Cents amount)
+    {
+        std::lock_guard<std::mutex> lk{write_mtx_};
+        add(-amount);
+    }
+
+    void deposit(Cents amount)
+    {
+        std::lock_guard<std::mutex> lk{write_mtx_};
+        add(amount);
+    }
+
+    int id() const
+    {
+        return id_;
+    }
+
+    // consistent balance and operation count, read without locking
+    AccountState state() const
+    {
+        for (;;)
+        {
+            const uint64_t before = sequence_.load(std::memory_order_acquire);
+            if (before % 2 == 1)
+            {
+                std::this_thread::yield(); // a writer is in the middle of a change
+                continue;
+            }
+
+            const AccountState s{balance_.load(std::memory_order_relaxed), no_of_operations_.load(std::memory_order_relaxed)};
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (sequence_.load(std::memory_order_relaxed) == before)
+                return s;
+        }
+    }
+
+    Cents balance() const
+    {
+        return state().balance;
+    }
+};
+
+#endif // SEQLOCK_BANK_ACCOUNT_HPP
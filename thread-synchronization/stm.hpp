@@ -0,0 +1,298 @@
+#ifndef STM_HPP
+#define STM_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "ledger.hpp"
+#include "money.hpp"
+
+// thrown by StmLedger::atomically when a transaction keeps conflicting with others
+class TransactionConflict : public std::runtime_error
+{
+public:
+    using std::runtime_error::runtime_error;
+};
+
+namespace Detail
+{
+    // aborts the current attempt of a transaction - never escapes StmLedger::atomically
+    struct RetryTransaction
+    {
+    };
+}
+
+// Accounts updated by optimistic transactions (software transactional memory in the style of TL2).
+// Every account has a versioned slot; a transaction reads balances without locking (recording what it read),
+// buffers its writes and at commit locks only the written slots, checks that nothing it read has changed
+// and publishes the writes with a new version. Any number of accounts can be changed atomically
+// without global locks and without deadlocks; conflicting transactions are retried.
+//
+//   ledger.atomically([&](StmLedger::Transaction& tx) {
+//       const Cents balance = tx.read(payer);
+//       if (balance < 3 * fee)
+//           return false; // rolls back
+//       tx.write(payer, balance - 3 * fee);
+//       for (auto payee : payees)
+//           tx.write(payee, tx.read(payee) + fee);
+//       return true;
+//   });
+class StmLedger
+{
+    static constexpr size_t cache_line_size = 64;
+    static constexpr uint64_t locked = 1; // lowest bit of Slot::version_lock
+
+    struct alignas(cache_line_size) Slot
+    {
+        std::atomic<uint64_t> version_lock{0}; // version << 1 | locked
+        std::atomic<Cents> balance{0};
+    };
+
+    const size_t no_of_accounts_;
+    std::unique_ptr<Slot[]> slots_;
+    std::atomic<uint64_t> clock_{0}; // version of the last commit
+    std::atomic<uint64_t> no_of_conflicts_{0};
+
+    void check_id(AccountId id) const
+    {
+        if (id >= no_of_accounts_)
+            throw std::out_of_range("invalid account id");
+    }
+
+public:
+    class Transaction
+    {
+        friend class StmLedger;
+
+        struct Write
+        {
+            AccountId id;
+            Cents balance;
+            uint64_t version_lock = 0; // value before the slot was locked by commit()
+        };
+
+        // read and write sets reused by all transactions of a thread (no allocations once they have grown)
+        struct Buffers
+        {
+            std::vector<AccountId> reads;
+            std::vector<Write> writes;
+            bool is_in_use = false;
+        };
+
+        StmLedger& ledger_;
+        const uint64_t read_version_;
+        std::vector<AccountId>& reads_;
+        std::vector<Write>& writes_;
+
+        Transaction(StmLedger& ledger, Buffers& buffers)
+            : ledger_{ledger}
+            , read_version_{ledger.clock_.load(std::memory_order_acquire)}
+            , reads_{buffers.reads}
+            , writes_{buffers.writes}
+        {
+            reads_.clear();
+            writes_.clear();
+        }
+
+        Write* find_write(AccountId id)
+        {
+            auto it = std::find_if(writes_.begin(), writes_.end(), [id](const Write& w) { return w.id == id; });
+            return it != writes_.end() ? &*it : nullptr;
+        }
+
+        void unlock(size_t no_of_locked)
+        {
+            for (size_t i = 0; i < no_of_locked; ++i)
+                ledger_.slots_[writes_[i].id].version_lock.store(writes_[i].version_lock, std::memory_order_release);
+        }
+
+        bool commit()
+        {
+            if (writes_.empty())
+                return true; // every read was consistent with read_version_
+
+            std::sort(writes_.begin(), writes_.end(), [](const Write& a, const Write& b) { return a.id < b.id; });
+
+            for (size_t i = 0; i < writes_.size(); ++i)
+            {
+                Slot& slot = ledger_.slots_[writes_[i].id];
+                uint64_t version_lock = slot.version_lock.load(std::memory_order_relaxed);
+
+                if ((version_lock & locked)
+                    || !slot.version_lock.compare_exchange_strong(version_lock, version_lock | locked, std::memory_order_acquire))
+                {
+                    unlock(i);
+                    return false;
+                }
+
+                writes_[i].version_lock = version_lock;
+            }
+
+            const uint64_t write_version = ledger_.clock_.fetch_add(1, std::memory_order_acq_rel) + 1;
+
+            // nobody committed since the transaction started - the reads are still valid
+            if (write_version != read_version_ + 1)
+            {
+                for (AccountId id : reads_)
+                {
+                    const uint64_t version_lock = ledger_.slots_[id].version_lock.load(std::memory_order_acquire);
+                    const bool is_locked_by_other = (version_lock & locked) && !find_write(id);
+
+                    if (is_locked_by_other || (version_lock >> 1) > read_version_)
+                    {
+                        unlock(writes_.size());
+                        return false;
+                    }
+                }
+            }
+
+            for (const auto& w : writes_)
+            {
+                Slot& slot = ledger_.slots_[w.id];
+                slot.balance.store(w.balance, std::memory_order_release);
+                slot.version_lock.store(write_version << 1, std::memory_order_release);
+            }
+
+            return true;
+        }
+
+    public:
+        Transaction(const Transaction&) = delete;
+        Transaction& operator=(const Transaction&) = delete;
+
+        // balance as of the start of the transaction (or the value written by it)
+        Cents read(AccountId id)
+        {
+            ledger_.check_id(id);
+
+            if (const Write* w = find_write(id))
+                return w->balance;
+
+            const Slot& slot = ledger_.slots_[id];
+            const uint64_t before = slot.version_lock.load(std::memory_order_acquire);
+            const Cents balance = slot.balance.load(std::memory_order_acquire);
+            const uint64_t after = slot.version_lock.load(std::memory_order_acquire);
+
+            if (before != after || (before & locked) || (before >> 1) > read_version_)
+                throw Detail::RetryTransaction{};
+
+            reads_.push_back(id);
+
+            return balance;
+        }
+
+        // buffered until commit
+        void write(AccountId id, Cents balance)
+        {
+            ledger_.check_id(id);
+
+            if (Write* w = find_write(id))
+                w->balance = balance;
+            else
+                writes_.push_back(Write{id, balance});
+        }
+    };
+
+    StmLedger(size_t no_of_accounts, Cents initial_balance)
+        : no_of_accounts_{no_of_accounts}
+        , slots_{new Slot[no_of_accounts]}
+    {
+        for (size_t i = 0; i < no_of_accounts_; ++i)
+            slots_[i].balance.store(initial_balance, std::memory_order_relaxed);
+    }
+
+    StmLedger(const StmLedger&) = delete;
+    StmLedger& operator=(const StmLedger&) = delete;
+
+    size_t size() const
+    {
+        return no_of_accounts_;
+    }
+
+    // Runs f(Transaction&) -> bool until it commits; when f returns false nothing is written.
+    // f may run several times, so it must not have other side effects (and must not swallow exceptions).
+    // Throws TransactionConflict after max_retries failed attempts; exceptions from f are propagated.
+    // Transactions cannot be nested.
+    template <typename F>
+    bool atomically(F f, int max_retries = 1000)
+    {
+        static thread_local Transaction::Buffers buffers;
+
+        if (buffers.is_in_use)
+            throw std::logic_error("nested StmLedger transaction");
+
+        buffers.is_in_use = true;
+        struct Release
+        {
+            bool& is_in_use;
+            ~Release() { is_in_use = false; }
+        } release{buffers.is_in_use};
+
+        for (int attempt = 0; attempt <= max_retries; ++attempt)
+        {
+            try
+            {
+                Transaction tx{*this, buffers};
+
+                if (!f(tx))
+                    return false;
+
+                if (tx.commit())
+                    return true;
+            }
+            catch (const Detail::RetryTransaction&)
+            {
+            }
+
+            no_of_conflicts_.fetch_add(1, std::memory_order_relaxed);
+            std::this_thread::yield();
+        }
+
+        throw TransactionConflict("transaction aborted after too many conflicts");
+    }
+
+    Cents balance(AccountId id)
+    {
+        Cents result = 0;
+        atomically([&](Transaction& tx) {
+            result = tx.read(id);
+            return true;
+        });
+
+        return result;
+    }
+
+    // throws std::invalid_argument for an amount <= 0
+    TransferStatus transfer(AccountId from, AccountId to, Cents amount)
+    {
+        check_id(from);
+        check_id(to);
+        check_amount(amount);
+
+        const bool is_done = atomically([&](Transaction& tx) {
+            const Cents balance = tx.read(from);
+            if (balance < amount)
+                return false;
+
+            tx.write(from, balance - amount);
+            tx.write(to, tx.read(to) + amount);
+            return true;
+        });
+
+        return is_done ? TransferStatus::ok : TransferStatus::insufficient_funds;
+    }
+
+    // number of transaction attempts that had to be retried
+    uint64_t no_of_conflicts() const
+    {
+        return no_of_conflicts_.load(std::memory_order_relaxed);
+    }
+};
+
+#endif // STM_HPP